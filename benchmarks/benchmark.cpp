@@ -0,0 +1,609 @@
+// Headless benchmark: builds synthetic widget trees and drives them through SDL's software renderer,
+// with no window and no GPU, so it runs the same everywhere and can be compared across changes.
+//
+// Usage: benchmark [--max-nodes N] [--frames N] [--budget SECONDS] [--scene NAME] [--font PATH] [--damage] [--arena] [--csv]
+// --arena builds the objects in the arena of the scene, see SceneManager::getArena().
+// --damage keeps the scene in a texture and only redraws the areas that changed, see SceneManager::setDamageTracking().
+// Run it from the repository root, or pass --font, the default font is ./res/fonts/mssan-serif.ttf.
+
+#include "guimanager.h"
+#include <lfmain>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+// Every allocation made while measuring is counted, to report allocations per frame
+namespace {
+    std::atomic<std::size_t> allocationCount { 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+    using namespace GUILib;
+
+    constexpr int OUTPUT_WIDTH = 1280, OUTPUT_HEIGHT = 720;
+
+    struct Options {
+        size_t maxNodes = 100000;
+        int frames = 200;
+        double budgetSeconds = 2.0;
+        std::string scene;
+        std::string fontPath = "./res/fonts/mssan-serif.ttf";
+        std::string imagePath = "./benchmark-icon.bmp";
+        bool damage = false;
+        bool arena = false;
+        bool csv = false;
+    };
+
+    /// @brief The objects of a synthetic scene.
+    struct Scene {
+        std::vector<std::shared_ptr<GuiObject>> roots;
+        /// @brief Resized every frame of the layout phase, which invalidates the whole tree.
+        std::shared_ptr<GuiObject> layoutRoot;
+        /// @brief Only set by the scenes that have a text edit phase.
+        std::shared_ptr<EditableTextBox> editor;
+    };
+
+    struct Context {
+        SDL_Renderer* renderer;
+        TTF_Font* font;
+        std::string imagePath;
+    };
+
+    struct SceneType {
+        const char* name;
+        /// @brief The largest size the scene is built at, some widgets don't share their resources yet.
+        size_t maxNodes;
+        std::function<Scene(const Context&, size_t)> build;
+    };
+
+    struct Result {
+        double fps, p50, p99, allocationsPerFrame;
+        /// @brief Render list counters, per frame: draw calls, texture switches between them, and commands merged into the previous draw call.
+        double drawCallsPerFrame, switchesPerFrame, mergedPerFrame;
+        int frames;
+    };
+
+    std::shared_ptr<Frame> makeRoot(const Context& context)
+    {
+        auto root = Frame::Builder()
+            .setRenderer(context.renderer)
+            .setSize({ OUTPUT_WIDTH, OUTPUT_HEIGHT, false })
+            .setPosition({ 0, 0, false })
+            .setVisible(true)
+            .setActive(true)
+            .build();
+        root->setFrameColor({ 240, 240, 240, 255 });
+        return root;
+    }
+
+    /// @brief Lays count objects out in a grid covering the parent, in scale units.
+    UIUnit gridCell(size_t index, size_t count, UIUnit& size)
+    {
+        const auto columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+        const size_t rows = (count + columns - 1) / columns;
+        size = { 1.0 / columns, 1.0 / rows, true };
+        return { static_cast<double>(index % columns) / columns, static_cast<double>(index / columns) / rows, true };
+    }
+
+    /// @brief Nested frames, eight children per frame.
+    Scene buildFrames(const Context& context, size_t nodes)
+    {
+        Scene scene;
+        auto root = makeRoot(context);
+        scene.roots.push_back(root);
+        scene.layoutRoot = root;
+
+        std::vector<std::shared_ptr<Frame>> frames = { root };
+        for (size_t i = 1; i < nodes; ++i) {
+            const auto& parent = frames[(i - 1) / 8];
+            const size_t slot = (i - 1) % 8;
+
+            auto frame = Frame::Builder()
+                .setRenderer(context.renderer)
+                .setParent(parent)
+                .setSize({ 0.3, 0.45, true })
+                .setPosition({ (slot % 4) * 0.24, (slot / 4) * 0.5, true })
+                .setVisible(true)
+                .setActive(true)
+                .build();
+            frame->setFrameColor({ static_cast<Uint8>(i * 37), static_cast<Uint8>(i * 91), 200, 255 });
+            frames.push_back(frame);
+        }
+        return scene;
+    }
+
+    /// @brief A scrolling frame holding a column of text buttons.
+    Scene buildScrolling(const Context& context, size_t nodes)
+    {
+        Scene scene;
+        auto root = makeRoot(context);
+        scene.roots.push_back(root);
+        scene.layoutRoot = root;
+
+        auto scrolling = ScrollingFrame::Builder()
+            .setRenderer(context.renderer)
+            .setParent(root)
+            .setSize({ 1, 1, true })
+            .setPosition({ 0, 0, true })
+            .setVisible(true)
+            .setActive(true)
+            .build();
+        scrolling->setChildrenRenderingState(true);
+        // Relative to the frame, like its size
+        scrolling->setContentSize({ 1, static_cast<double>(nodes) * 30 / OUTPUT_HEIGHT, true });
+
+        for (size_t i = 0; i < nodes; ++i) {
+            auto button = TextButton::Builder()
+                .setRenderer(context.renderer)
+                .setParent(scrolling)
+                .setSize({ OUTPUT_WIDTH - 40, 28, false })
+                .setPosition({ 0, static_cast<double>(i) * 30, false })
+                .setVisible(true)
+                .setActive(true)
+                .build();
+            button->changeFont(context.font);
+            button->setText("Button " + std::to_string(i));
+        }
+        return scene;
+    }
+
+    /// @brief A grid of text boxes.
+    Scene buildTextBoxes(const Context& context, size_t nodes)
+    {
+        Scene scene;
+        auto root = makeRoot(context);
+        scene.roots.push_back(root);
+        scene.layoutRoot = root;
+
+        TTF_Font* font = context.font;
+        for (size_t i = 0; i < nodes; ++i) {
+            UIUnit size;
+            const UIUnit position = gridCell(i, nodes, size);
+
+            auto box = TextBox::Builder()
+                .setRenderer(context.renderer)
+                .setParent(root)
+                .setSize(size)
+                .setPosition(position)
+                .setVisible(true)
+                .setActive(true)
+                .build();
+            box->changeFont(font);
+            box->setText("Text box number " + std::to_string(i));
+        }
+        return scene;
+    }
+
+    /// @brief A grid of text buttons, hovered and clicked by the event phase.
+    Scene buildButtons(const Context& context, size_t nodes)
+    {
+        Scene scene;
+        auto root = makeRoot(context);
+        scene.roots.push_back(root);
+        scene.layoutRoot = root;
+
+        for (size_t i = 0; i < nodes; ++i) {
+            UIUnit size;
+            const UIUnit position = gridCell(i, nodes, size);
+
+            auto button = TextButton::Builder()
+                .setRenderer(context.renderer)
+                .setParent(root)
+                .setSize(size)
+                .setPosition(position)
+                .setVisible(true)
+                .setActive(true)
+                .build();
+            button->changeFont(context.font);
+            button->changeHoverColor({ 200, 200, 255, 255 });
+            button->setText(std::to_string(i));
+        }
+        return scene;
+    }
+
+    /// @brief A combo box with an option per node, opened.
+    Scene buildComboBox(const Context& context, size_t nodes)
+    {
+        Scene scene;
+        auto root = makeRoot(context);
+        scene.roots.push_back(root);
+        scene.layoutRoot = root;
+
+        auto combo = ComboBox::Builder()
+            .setRenderer(context.renderer)
+            .setParent(root)
+            .setSize({ 0.3, 0.05, true })
+            .setPosition({ 0.1, 0.1, true })
+            .setVisible(true)
+            .setActive(true)
+            .build();
+        combo->initialize(context.renderer);
+        combo->setFont(context.font);
+        combo->setButtonColor({ 220, 220, 220, 255 });
+        combo->setOptionBoxColor({ 250, 250, 250, 255 });
+        combo->setOptionBoxLength(10);
+        for (size_t i = 1; i < nodes; ++i) {
+            combo->addOption("Option " + std::to_string(i));
+        }
+        combo->setOptionBoxVisibility(true);
+        return scene;
+    }
+
+    /// @brief A grid of images, all showing the same file.
+    Scene buildImages(const Context& context, size_t nodes)
+    {
+        Scene scene;
+        auto root = makeRoot(context);
+        scene.roots.push_back(root);
+        scene.layoutRoot = root;
+
+        for (size_t i = 0; i < nodes; ++i) {
+            UIUnit size;
+            const UIUnit position = gridCell(i, nodes, size);
+
+            auto image = Image::Builder()
+                .setRenderer(context.renderer)
+                .setParent(root)
+                .setSize(size)
+                .setPosition(position)
+                .setVisible(true)
+                .setActive(true)
+                .build();
+            image->updatePath(context.imagePath);
+        }
+        return scene;
+    }
+
+    /// @brief An editable text box holding a line per node.
+    Scene buildEditor(const Context& context, size_t nodes)
+    {
+        Scene scene;
+        auto root = makeRoot(context);
+        scene.roots.push_back(root);
+        scene.layoutRoot = root;
+
+        auto editor = EditableTextBox::Builder()
+            .setRenderer(context.renderer)
+            .setParent(root)
+            .setSize({ 1, 1, true })
+            .setPosition({ 0, 0, true })
+            .setVisible(true)
+            .setActive(true)
+            .build();
+
+        TTF_Font* font = context.font;
+        editor->changeFont(font);
+        editor->setTextAlignment(HorizontalTextAlign::LEFT, VerticalTextAlign::UP);
+        editor->setEditable(true);
+
+        std::string text;
+        for (size_t i = 0; i < nodes; ++i) {
+            text += "The quick brown fox jumps over the lazy dog, line " + std::to_string(i) + '\n';
+        }
+        editor->setText(text);
+
+        scene.editor = editor;
+        return scene;
+    }
+
+    /// @brief Runs frame() until the amount of frames or the time budget is reached, whichever comes first.
+    template <typename FrameFunction>
+    Result measure(const Options& options, SDL_Renderer* renderer, FrameFunction&& frame)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Warm the caches up, the first frame builds them
+        frame(0);
+        Reserved::RenderList::get(renderer).resetStats();
+
+        std::vector<double> times;
+        times.reserve(options.frames);
+        std::size_t allocations = 0;
+
+        const auto start = Clock::now();
+        for (int i = 1; i <= options.frames; ++i) {
+            const std::size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            const auto frameStart = Clock::now();
+
+            frame(i);
+
+            const auto frameEnd = Clock::now();
+            allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            times.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+
+            // At least a few frames, so the percentiles mean something
+            if (i >= 5 && std::chrono::duration<double>(frameEnd - start).count() > options.budgetSeconds) break;
+        }
+
+        double total = 0;
+        for (const double time : times) total += time;
+        std::sort(times.begin(), times.end());
+
+        const auto percentile = [&](double p) {
+            return times[std::min(times.size() - 1, static_cast<size_t>(p * static_cast<double>(times.size())))];
+        };
+
+        Result result {};
+        result.frames = static_cast<int>(times.size());
+        result.fps = total > 0 ? 1000.0 * static_cast<double>(times.size()) / total : 0;
+        result.p50 = percentile(0.5);
+        result.p99 = percentile(0.99);
+        result.allocationsPerFrame = static_cast<double>(allocations) / static_cast<double>(times.size());
+
+        // A device reset in between would have dropped the list, the counters then start over
+        const auto& stats = Reserved::RenderList::get(renderer).getStats();
+        const auto perFrame = [&](size_t count) { return static_cast<double>(count) / static_cast<double>(times.size()); };
+        result.drawCallsPerFrame = perFrame(stats.drawCalls);
+        result.switchesPerFrame = perFrame(stats.textureSwitches);
+        result.mergedPerFrame = perFrame(stats.merged);
+        return result;
+    }
+
+    void printHeader(const Options& options)
+    {
+        if (options.csv) {
+            std::cout << "scene,nodes,phase,frames,fps,p50_ms,p99_ms,allocs_per_frame,draw_calls_per_frame,texture_switches_per_frame,merged_per_frame\n";
+            return;
+        }
+        std::cout << "unit kernel: " << GUILib::Reserved::getUnitKernelName() << '\n';
+        std::cout << std::left << std::setw(12) << "scene" << std::right << std::setw(8) << "nodes" << "  "
+                  << std::left << std::setw(10) << "phase" << std::right
+                  << std::setw(8) << "frames" << std::setw(12) << "fps"
+                  << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms"
+                  << std::setw(14) << "allocs/frame" << std::setw(13) << "calls/frame"
+                  << std::setw(15) << "switches/frame" << std::setw(14) << "merged/frame" << '\n';
+    }
+
+    void printResult(const Options& options, const char* scene, size_t nodes, const char* phase, const Result& result)
+    {
+        if (options.csv) {
+            std::cout << scene << ',' << nodes << ',' << phase << ',' << result.frames << ','
+                      << result.fps << ',' << result.p50 << ',' << result.p99 << ',' << result.allocationsPerFrame << ','
+                      << result.drawCallsPerFrame << ',' << result.switchesPerFrame << ',' << result.mergedPerFrame << '\n';
+            return;
+        }
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::left << std::setw(12) << scene << std::right << std::setw(8) << nodes << "  "
+                  << std::left << std::setw(10) << phase << std::right
+                  << std::setw(8) << result.frames
+                  << std::setprecision(1) << std::setw(12) << result.fps
+                  << std::setprecision(3) << std::setw(10) << result.p50 << std::setw(10) << result.p99
+                  << std::setprecision(1) << std::setw(14) << result.allocationsPerFrame << std::setw(13) << result.drawCallsPerFrame
+                  << std::setw(15) << result.switchesPerFrame << std::setw(14) << result.mergedPerFrame << '\n';
+    }
+
+    /// @brief Appends an object and all of its descendants.
+    void collectObjects(const std::shared_ptr<GuiObject>& obj, std::vector<std::shared_ptr<GuiObject>>& out)
+    {
+        out.push_back(obj);
+        for (const auto& child : obj->getChildren()) {
+            if (child) collectObjects(child, out);
+        }
+    }
+
+    void runScene(const Options& options, const Context& context, const SceneType& type, size_t nodes)
+    {
+        // Build: the whole tree created and dropped again
+        printResult(options, type.name, nodes, "build", measure(options, context.renderer, [&](int) {
+            const ArenaScope scope(options.arena ? std::make_shared<Reserved::NodeArena>() : nullptr);
+            const Scene built = type.build(context, nodes);
+        }));
+
+        SceneManager sceneManager(context.renderer);
+        const Scene scene = [&] {
+            const ArenaScope scope(options.arena ? sceneManager.getArena() : nullptr);
+            return type.build(context, nodes);
+        }();
+        for (const auto& root : scene.roots) sceneManager.add(root);
+        sceneManager.setBackgroundColor({ 255, 255, 255, 255 });
+        sceneManager.setDamageTracking(options.damage);
+
+        const auto renderFrame = [&]() {
+            // The target texture covers the whole output already
+            if (!options.damage) {
+                SDL_SetRenderDrawColor(context.renderer, 255, 255, 255, 255);
+                SDL_RenderClear(context.renderer);
+            }
+            sceneManager.render();
+            SDL_RenderPresent(context.renderer);
+        };
+
+        // Layout: the root changes size, so every object has to be laid out again
+        printResult(options, type.name, nodes, "layout", measure(options, context.renderer, [&](int frame) {
+            const double width = OUTPUT_WIDTH - (frame % 2);
+            scene.layoutRoot->resize({ width, OUTPUT_HEIGHT, false });
+            for (const auto& root : scene.roots) root->updateLayout();
+        }));
+
+        // Events: pointer motion all over the scene, a click and a wheel step
+        std::uint32_t seed = 12345;
+        const auto random = [&seed](int limit) {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<int>((seed >> 8) % static_cast<std::uint32_t>(limit));
+        };
+        printResult(options, type.name, nodes, "events", measure(options, context.renderer, [&](int frame) {
+            SDL_Event event {};
+            for (int i = 0; i < 8; ++i) {
+                event.type = SDL_MOUSEMOTION;
+                event.motion.x = random(OUTPUT_WIDTH);
+                event.motion.y = random(OUTPUT_HEIGHT);
+                sceneManager.handleEvent(event);
+            }
+
+            const int x = random(OUTPUT_WIDTH), y = random(OUTPUT_HEIGHT);
+            event = {};
+            event.type = SDL_MOUSEBUTTONDOWN;
+            event.button.button = SDL_BUTTON_LEFT;
+            event.button.x = x;
+            event.button.y = y;
+            sceneManager.handleEvent(event);
+            event.type = SDL_MOUSEBUTTONUP;
+            sceneManager.handleEvent(event);
+
+            event = {};
+            event.type = SDL_MOUSEWHEEL;
+            event.wheel.y = frame % 8 < 4 ? -1 : 1;
+            sceneManager.handleEvent(event);
+        }));
+
+        printResult(options, type.name, nodes, "render", measure(options, context.renderer, [&](int) {
+            renderFrame();
+        }));
+
+        // Text edit: a character typed every frame, a backspace every fourth one, rendered
+        if (scene.editor) {
+            sceneManager.setFocus(scene.editor);
+            printResult(options, type.name, nodes, "text edit", measure(options, context.renderer, [&](int frame) {
+                SDL_Event event {};
+                if (frame % 4 == 3) {
+                    event.type = SDL_KEYDOWN;
+                    event.key.keysym.sym = SDLK_BACKSPACE;
+                }
+                else {
+                    event.type = SDL_TEXTINPUT;
+                    event.text.text[0] = static_cast<char>('a' + frame % 26);
+                }
+                sceneManager.handleEvent(event);
+                renderFrame();
+            }));
+        }
+
+        // Tweens: every object moving back and forth, advanced together and rendered
+        std::vector<std::shared_ptr<GuiObject>> animated;
+        for (const auto& root : scene.roots) collectObjects(root, animated);
+        auto& tweens = sceneManager.getTweens();
+        printResult(options, type.name, nodes, "tweens", measure(options, context.renderer, [&](int frame) {
+            if (frame % 30 == 0) {
+                const double direction = frame % 60 == 0 ? 1.0 : -1.0;
+                for (const auto& obj : animated) {
+                    UIUnit to = obj->getPosition();
+                    to.sizeX += direction * (to.isUsingScale ? 0.01 : 8.0);
+                    tweens.start(obj, TweenType::POSITION, to, 0.5);
+                }
+            }
+            tweens.update(1.0 / 60.0);
+            renderFrame();
+        }));
+        tweens.clear();
+
+        sceneManager.clearAll();
+        sceneManager.setDamageTracking(false);
+    }
+
+    /// @brief Writes a small bitmap for the image scene, so it doesn't depend on a large file.
+    bool writeIcon(const std::string& path)
+    {
+        SDL_Surface* icon = SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!icon) return false;
+        SDL_FillRect(icon, nullptr, SDL_MapRGBA(icon->format, 80, 140, 220, 255));
+        const SDL_Rect inner = { 8, 8, 16, 16 };
+        SDL_FillRect(icon, &inner, SDL_MapRGBA(icon->format, 240, 200, 60, 255));
+        const bool saved = SDL_SaveBMP(icon, path.c_str()) == 0;
+        SDL_FreeSurface(icon);
+        return saved;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (argument == "--max-nodes" && hasValue) options.maxNodes = std::strtoull(argv[++i], nullptr, 10);
+            else if (argument == "--frames" && hasValue) options.frames = std::max(5, std::atoi(argv[++i]));
+            else if (argument == "--budget" && hasValue) options.budgetSeconds = std::atof(argv[++i]);
+            else if (argument == "--scene" && hasValue) options.scene = argv[++i];
+            else if (argument == "--font" && hasValue) options.fontPath = argv[++i];
+            else if (argument == "--damage") options.damage = true;
+            else if (argument == "--arena") options.arena = true;
+            else if (argument == "--csv") options.csv = true;
+            else {
+                std::cerr << "Usage: " << argv[0]
+                          << " [--max-nodes N] [--frames N] [--budget SECONDS] [--scene NAME] [--font PATH] [--damage] [--arena] [--csv]\n";
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    // No window, no GPU: everything is drawn into a surface in memory
+    if (SDL_Init(0) != 0 || TTF_Init() != 0) {
+        std::cerr << SDL_GetError() << '\n';
+        return 1;
+    }
+    IMG_Init(IMG_INIT_PNG);
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, OUTPUT_WIDTH, OUTPUT_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        std::cerr << SDL_GetError() << '\n';
+        return 1;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    TTF_Font* font = TTF_OpenFont(options.fontPath.c_str(), 15);
+    if (!font) {
+        std::cerr << TTF_GetError() << '\n';
+        return 1;
+    }
+
+    const bool hasIcon = writeIcon(options.imagePath);
+    const Context context = { renderer, font, options.imagePath };
+
+    const std::vector<SceneType> scenes = {
+        { "frames", 100000, buildFrames },
+        { "scrolling", 100000, buildScrolling },
+        { "textboxes", 100000, buildTextBoxes },
+        { "buttons", 100000, buildButtons },
+        { "combobox", 10000, buildComboBox },
+        { "images", hasIcon ? 100000u : 0u, buildImages },
+        { "editor", 100000, buildEditor },
+    };
+
+    printHeader(options);
+    for (const auto& scene : scenes) {
+        if (!options.scene.empty() && options.scene != scene.name) continue;
+
+        for (size_t nodes = 10; nodes <= std::min(options.maxNodes, scene.maxNodes); nodes *= 10) {
+            runScene(options, context, scene, nodes);
+        }
+    }
+
+    if (hasIcon) std::remove(options.imagePath.c_str());
+
+    TTF_CloseFont(font);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    IMG_Quit();
+    TTF_Quit();
+    SDL_Quit();
+    return 0;
+}
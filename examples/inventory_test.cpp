@@ -48,6 +48,8 @@ public:
 		trigger("onChanged");
 	}
 	[[nodiscard]] std::vector<Item> getItems() const { return items; }
+	[[nodiscard]] const Item& getItem(size_t index) const { return items[index]; }
+	[[nodiscard]] size_t getItemCount() const { return items.size(); }
 
 	void removeItems(int id)
 	{
@@ -93,9 +95,7 @@ enum class GridLayout : uint8_t
 
 class InventoryGui final : public GUILib::Frame {
 private:
-	std::shared_ptr<GUILib::ScrollingFrame> mainContentFrame;
-	
-	std::vector<std::shared_ptr<GUILib::TextButton>> invButtons;
+	std::shared_ptr<GUILib::GridView> mainContentFrame;
 
 	TTF_Font* buttonTextFont;
 public:
@@ -108,7 +108,7 @@ public:
 	}
 	void init()
 	{
-		mainContentFrame = GUILib::ScrollingFrame::Builder()
+		mainContentFrame = GUILib::GridView::Builder()
 			.setSize({ 1, 0.8, true })
 			.setPosition({ 0, 0.2, true })
 			.setParent(shared_from_this())
@@ -132,7 +132,34 @@ public:
 			static_cast<Uint8>(frameColor.b - 15),
 			255
 			});
-		p->setContentSize({ 1, 1.5, true });
+		p->setItemWidth(64);
+		p->setItemHeight(48);
+
+		// Only the visible cells get a button, they are rebound to other items while scrolling
+		p->setItemFactory([this]()
+		{
+			const auto button = GUILib::TextButton::Builder()
+				.setVisible(true)
+				.setActive(true)
+				.build();
+
+			button->changeFont(buttonTextFont);
+			button->changeButtonColor(this->frameColor);
+			button->changeTextColor({ 0, 0, 0, 255 });
+			return std::static_pointer_cast<GuiObject>(button);
+		});
+		p->setItemBinder([this](const std::shared_ptr<GuiObject>& view, size_t index)
+		{
+			const auto button = std::static_pointer_cast<GUILib::TextButton>(view);
+			const Item item = inventory.getItem(index);
+
+			button->setText(item.getName());
+			button->onClick.reset();
+			button->onClick.connect([this, item](int, int)
+			{
+				inventory.setActiveItem(item);
+			});
+		});
 
 		p->setVisible(true);
 		p->setActive(true);
@@ -183,54 +210,7 @@ public:
 			return;
 		}
 
-		for (const auto& button : invButtons)
-		{
-			button->setParent(nullptr);
-		}
-		invButtons.clear();
-		constexpr int totalCols = 9, totalRows = 4;
-		int numItems = static_cast<int>(inventory.getItems().size());
-
-		constexpr int totalCells = totalCols * totalRows;
-		numItems = std::min(numItems, totalCells);
-
-		// Determine cell size
-		constexpr double cellWidth = 1.0 / totalCols;
-		constexpr  double cellHeight = 1.0 / totalRows;
-
-
-		for (int i = 0; i < numItems; ++i) {
-			const int cellIndex = i;
-			const int col = cellIndex % totalCols;
-			const int row = cellIndex / totalCols;
-
-			// Center item inside its cell
-			const double posX = col * cellWidth + (cellWidth - 0.1) / 2.0;
-			const double posY = row * cellHeight + (cellHeight - 0.2) / 2.0;
-
-			const auto button = GUILib::TextButton::Builder()
-				.setPosition({ posX, posY, true })
-				.setSize({ 0.1, 0.2, true })
-				.setRenderer(this->ref)
-				.setParent(mainContentFrame)
-				.setVisible(true)
-				.setActive(true)
-				.build();
-
-			const Item activeItem = inventory.getItems()[i];
-
-			button->changeFont(buttonTextFont);
-			button->changeButtonColor(this->frameColor);
-			button->changeTextColor({ 0, 0, 0, 255 });
-			button->setText(activeItem.getName());
-
-			button->on("onClick", std::function([this, activeItem](int x, int y) 
-			{
-				inventory.setActiveItem(activeItem);
-			}));
-
-			invButtons.push_back(button);
-		}
+		mainContentFrame->setItemCount(inventory.getItemCount());
 	}
 
 	void handleEvent(const SDL_Event& event) override
@@ -336,34 +316,14 @@ int main(int argc, char* argv[])
 
 	sceneManager.addBulk(openInvButton, invGui);
 	sceneManager.initialize(renderer);
+	// Only the parts of the inventory that change are drawn again
+	sceneManager.setBackgroundColor({ 255, 255, 255, 255 });
+	sceneManager.setDamageTracking(true);
 
-	bool isRunning = true;
-
-	while (isRunning)
-	{
-		SDL_Event e;
-		while (SDL_PollEvent(&e))
-		{
-			switch (e.type)
-			{
-			case SDL_WINDOWEVENT_CLOSE:
-			case SDL_QUIT:
-				isRunning = false;
-				break;
-			default: break;
-			}
-			sceneManager.handleEvent(e);
-		}
-		SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-		SDL_RenderClear(renderer);
-
-		sceneManager.render();
-
-		SDL_RenderPresent(renderer);
-
-		SDL_Delay(16);
-	}
+	// Draws at most 60 frames per second, only when something changed, and sleeps while nothing happens
+	sceneManager.run();
 
+	sceneManager.setDamageTracking(false);
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 	TTF_CloseFont(font);
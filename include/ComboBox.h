@@ -1,8 +1,8 @@
 #pragma once
 
-#include "GuiObject.h"
-#include "Frame.h"
-#include "Button.h"
+#include "guiobject.h"
+#include "frame.h"
+#include "button.h"
 
 namespace GUILib {
 
@@ -34,7 +34,7 @@ namespace GUILib {
 
         void removeOptionByName(const std::string& text);
 
-        void handleEvent(const SDL_Event& e) override;
+        void processEvent(const SDL_Event& e) override;
 
         [[nodiscard]] int getOptionBoxLength() const;
         void setOptionBoxLength(const int& val);
@@ -1,13 +1,8 @@
 #pragma once
 
-#include "GuiObject.h"
+#include "guiobject.h"
 
 namespace GUILib {
-    enum class TweenType {
-        SIZE,
-        POSITION
-    };
-
 	struct TweenInfo {
         bool active = false;
         double elapsed = 0.0;
@@ -17,6 +12,8 @@ namespace GUILib {
         TweenType type;
 	};
 
+	/// @brief Runs one tween at a time, driven by the caller.
+	/// For many tweens at once, see TweenScheduler.
 	class TweenService {
     protected:
         static inline bool validateSizeScale(const UIUnit& u1, const UIUnit& u2) {
@@ -27,6 +24,10 @@ namespace GUILib {
             switch (type) {
             case TweenType::SIZE: state.start = obj->getSize(); break;
             case TweenType::POSITION: state.start = obj->getPosition(); break;
+            case TweenType::PIVOT: state.start = obj->getPivotOffset(); break;
+            default:
+                std::cout << "TweenService only tweens the size, position and pivot offset. Please use a TweenScheduler for the other properties.\n";
+                return;
             }
             if (!validateSizeScale(state.start, to)) {
                 std::cout << "Tween position type mismatch. Please use 2 UIUnits with the same isUsingScale property.\n";
@@ -53,6 +54,8 @@ namespace GUILib {
             switch (state.type) {
             case TweenType::POSITION: obj->move(newPos); break;
             case TweenType::SIZE: obj->resize(newPos); break;
+            case TweenType::PIVOT: obj->setPivotOffset(newPos); break;
+            default: break;
             }
 
             if (t >= 1.0) {
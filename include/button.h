@@ -5,6 +5,7 @@
 
 #include "types.h"
 #include "guiobject.h"
+#include "textureCache.h"
 
 namespace GUILib {
 
@@ -26,6 +27,8 @@ namespace GUILib {
         bool hovered;
         /// @brief The class name.
 		static inline const std::string CLASS_NAME = "Button";
+
+        Reserved::SignalBase* findSignal(std::string_view eventName) override;
 		
         Button(
             std::shared_ptr<GuiObject> parent,
@@ -34,6 +37,11 @@ namespace GUILib {
             UIUnit position = UIUnit()
         );
     public:
+        /// @brief Fired while the pointer is over the button, with the pointer position.
+        Signal<int, int> onHover;
+        /// @brief Fired when the button is clicked, with the pointer position.
+        Signal<int, int> onClick;
+
         Button();
 
         /// @deprecated Migrate to the event system.
@@ -45,7 +53,7 @@ namespace GUILib {
 
         /// @brief Handles all event for the button.
         /// @param e The event to be handled.
-        void handleEvent(const SDL_Event& e) override;
+        void processEvent(const SDL_Event& e) override;
 
         /// @brief Checks if the button is hovered.
         /// @return The value.
@@ -97,6 +105,11 @@ namespace GUILib {
         /// @brief The class name.
 		static inline const std::string CLASS_NAME = "TextButton";
 
+        bool getTweenValue(TweenType type, double* values) const override;
+        void setTweenValue(TweenType type, const double* values) override;
+
+        Reserved::SignalBase* findSignal(std::string_view eventName) override;
+
         
         TextButton(
             std::shared_ptr<GuiObject> parent,
@@ -112,6 +125,9 @@ namespace GUILib {
             VerticalTextAlign alignY = VerticalTextAlign::CENTER
         );
     public:
+        /// @brief Fired by setText(), with the new text.
+        Signal<const std::string&> onTextChange;
+
 		TextButton();
 
         class Builder final : public Button::Builder<Builder, TextButton> {};
@@ -183,10 +199,10 @@ namespace GUILib {
     /// @brief A basic image button wrapper.
     class ImageButton : public Button {
     protected:
-        /// @brief The texture of the button.
-        SDL_Texture* buttonTexture;
-        /// @brief The hover texture of the button.
-        SDL_Texture* hoverTexture;
+        /// @brief The texture of the button, shared through the texture cache.
+        Reserved::TextureRegion buttonTexture;
+        /// @brief The hover texture of the button, shared through the texture cache.
+        Reserved::TextureRegion hoverTexture;
         
         static int nextId;
 
@@ -200,6 +216,8 @@ namespace GUILib {
         /// @brief The class name.
 		static inline const std::string CLASS_NAME = "ImageButton";
 
+        Reserved::SignalBase* findSignal(std::string_view eventName) override;
+
         
         ImageButton(
             std::shared_ptr<GuiObject> parent,
@@ -210,6 +228,11 @@ namespace GUILib {
             std::string hoverImageFilePath = ""
         );
     public:
+        /// @brief Fired by updateDefaultImgPath(), with the new path.
+        Signal<const char*> onPathUpdate;
+        /// @brief Fired by updateHoverImgPath(), with the new path.
+        Signal<const char*> onHoverPathUpdate;
+
 		ImageButton();
 
         class Builder final : public Button::Builder<Builder, ImageButton> {};
@@ -256,6 +279,14 @@ namespace GUILib {
         /// @brief The class name.
 		static inline const std::string CLASS_NAME = "CheckBox";
 
+    protected:
+        /// @brief The "onClick" event of a check box is onToggle, which carries no position.
+        Reserved::SignalBase* findSignal(std::string_view eventName) override;
+
+    private:
+        /// @brief Shows the symbol if the box is checked, nothing otherwise.
+        void refreshSymbol();
+
         CheckBox(
             std::shared_ptr<GuiObject> parent,
             SDL_Renderer*& renderer,
@@ -267,6 +298,9 @@ namespace GUILib {
             char symbol = 'X'
         );
     public:
+        /// @brief Fired when the box is clicked and its checked state toggled.
+        Signal<> onToggle;
+
         CheckBox();
 
         class Builder final : public Button::Builder<Builder, CheckBox> {};
@@ -299,7 +333,7 @@ namespace GUILib {
 
         /// @brief Handles the event.
         /// @param event The event to be handled.
-        void handleEvent(const SDL_Event& event) override;
+        void processEvent(const SDL_Event& event) override;
 
         /// @brief Returns the class name of the object.
 		/// @return The class name.
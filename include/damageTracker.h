@@ -0,0 +1,47 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief A renderer-scoped set of screen areas whose pixels changed since they were last drawn.
+        /// Overlapping areas are merged, and past MAX_RECTS areas everything is merged into their bounding box,
+        /// so the set stays small no matter how many objects change.
+        class DamageTracker {
+        public:
+            /// @brief Returns the tracker associated with the renderer, creating it if needed.
+            /// @param r The renderer.
+            /// @returns The tracker.
+            static DamageTracker& get(SDL_Renderer* r);
+
+            /// @brief Drops the tracker of the renderer.
+            /// @param r The renderer.
+            static void releaseRenderer(SDL_Renderer* r);
+
+            /// @brief Marks an area as changed. Empty areas are ignored.
+            /// @param rect The area, in renderer coordinates.
+            void add(const SDL_Rect& rect);
+
+            /// @brief Marks the whole output as changed.
+            void addAll();
+
+            /// @brief Returns whether nothing changed.
+            [[nodiscard]] bool isEmpty() const;
+
+            /// @brief Returns the changed areas within the bounds and forgets all of them.
+            /// @param bounds The output area.
+            /// @returns The areas, not overlapping each other.
+            [[nodiscard]] std::vector<SDL_Rect> take(const SDL_Rect& bounds);
+
+            /// @brief The most areas kept apart.
+            static constexpr size_t MAX_RECTS = 8;
+
+        private:
+            std::vector<SDL_Rect> rects;
+            /// @brief Whether the whole output changed, rects are unused then.
+            bool full = false;
+        };
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    /// @brief A curve mapping the progress of a tween to how far its value got.
+    /// Curves registered with Easing take the values after the built-in ones.
+    enum class EasingCurve : std::uint16_t {
+        LINEAR,
+        QUAD_IN,
+        QUAD_OUT,
+        QUAD_IN_OUT,
+        CUBIC_IN,
+        CUBIC_OUT,
+        CUBIC_IN_OUT,
+        BACK_IN,
+        BACK_OUT,
+        BACK_IN_OUT,
+        ELASTIC_IN,
+        ELASTIC_OUT,
+        ELASTIC_IN_OUT,
+        BOUNCE_IN,
+        BOUNCE_OUT,
+        BOUNCE_IN_OUT
+    };
+
+    /// @brief Holds the easing curves, each sampled into a small table when it's registered.
+    /// Evaluating a curve is a lookup and a linear interpolation between two samples, whatever the curve.
+    /// Not thread safe, curves are registered and evaluated on the thread owning the objects.
+    class Easing {
+    public:
+        /// @brief The amount of intervals a curve is sampled over, its table holds one sample more.
+        static constexpr size_t INTERVALS = 256;
+
+        /// @brief Registers a curve.
+        /// @param curve The curve, called with progresses from 0 to 1. Should map 0 to 0 and 1 to 1.
+        /// @returns The curve, to pass to tweens.
+        static EasingCurve registerCurve(const std::function<double(double)>& curve);
+
+        /// @brief Registers a cubic Bézier curve going from (0, 0) to (1, 1), like cubic-bezier() in CSS.
+        /// @param x1 The x of the first control point, clamped to [0, 1].
+        /// @param y1 The y of the first control point.
+        /// @param x2 The x of the second control point, clamped to [0, 1].
+        /// @param y2 The y of the second control point.
+        /// @returns The curve, to pass to tweens.
+        static EasingCurve registerCubicBezier(double x1, double y1, double x2, double y2);
+
+        /// @brief Evaluates a curve.
+        /// @param curve The curve. Curves that were never registered are linear.
+        /// @param progress The progress, clamped to [0, 1].
+        [[nodiscard]] static double evaluate(EasingCurve curve, double progress);
+
+        /// @brief Returns the table of a curve, INTERVALS + 1 samples. Moves when a curve is registered.
+        /// @param curve The curve. Curves that were never registered are linear.
+        [[nodiscard]] static const double* getSamples(EasingCurve curve);
+
+        /// @brief Evaluates the table of a curve.
+        /// @param samples The table, see getSamples().
+        /// @param progress The progress, clamped to [0, 1].
+        [[nodiscard]] static double interpolate(const double* samples, double progress)
+        {
+            const double position = std::clamp(progress, 0.0, 1.0) * static_cast<double>(INTERVALS);
+            const size_t index = std::min(static_cast<size_t>(position), INTERVALS - 1);
+            return samples[index] + (samples[index + 1] - samples[index]) * (position - static_cast<double>(index));
+        }
+
+    private:
+        /// @brief The tables of every curve, one after the other in the order of the curves.
+        static std::vector<double>& tables();
+    };
+}
@@ -227,9 +227,10 @@ namespace GUILib {
          */
         template <typename... Args>
         void fire(const std::string& eventName, Args&&... args) {
-            if (!listeners.count(eventName) || listeners[eventName].empty()) return;
+            const auto it = listeners.find(eventName);
+            if (it == listeners.end() || it->second.empty()) return;
             std::vector<std::any> packedArgs = { std::forward<Args>(args)... };
-            for (const auto& callback : listeners[eventName]) {
+            for (const auto& callback : it->second) {
                 callback.second(packedArgs);
             }
         }
@@ -298,4 +299,168 @@ namespace GUILib {
             return std::make_tuple(std::any_cast<Args>(args[I])...);
         }
     };
-}
\ No newline at end of file
+
+    namespace Reserved {
+        /// @brief The type-erased side of a Signal, used by the string based API to reach a signal by its name.
+        /// The erased callbacks and arguments must match signature(), which the caller has to check first.
+        class SignalBase {
+        public:
+            virtual ~SignalBase() = default;
+
+            /// @brief Returns the typeid of std::tuple<std::decay_t<Args>...>, Args being the arguments of the signal.
+            [[nodiscard]] virtual const std::type_info& signature() const = 0;
+
+            /// @brief Connects a callback.
+            /// @param callback A pointer to a std::function<void(const std::decay_t<Args>&...)>.
+            /// @param once Whether the callback is disconnected after its first call.
+            /// @return The id of the listener.
+            virtual size_t connectErased(const void* callback, bool once) = 0;
+
+            /// @brief Fires the signal.
+            /// @param args A pointer to a std::tuple<std::decay_t<Args>...>.
+            virtual void fireErased(const void* args) = 0;
+
+            /// @brief Deregisters a listener.
+            /// @param id The id received when connecting.
+            virtual void disconnect(size_t id) = 0;
+
+            /// @brief Deregisters all listeners.
+            virtual void reset() = 0;
+        };
+    }
+
+    /** @brief Statically typed event.
+     * Unlike EventEmitter, firing does no lookup and no allocation, and costs a single branch when nobody listens.
+     * The arguments are passed to the listeners by const reference.
+     * ```
+     * Signal<int, int> onClick;
+     *
+     * auto id = onClick.connect([](int x, int y) {
+     *     std::cout << x << ", " << y << std::endl;
+     * });
+     *
+     * onClick.fire(1, 2); // Outputs "1, 2"
+     * onClick.disconnect(id);
+     * ```
+     * Listeners can connect or disconnect (even themselves) from a callback. Listeners connected during a fire are
+     * only called from the next one.
+     */
+    template <typename... Args>
+    class Signal final : public Reserved::SignalBase {
+    public:
+        using EventId = EventEmitter::EventId;
+        using Callback = std::function<void(Args...)>;
+
+        /// @brief Registers a listener.
+        /// @param callback The callback function.
+        /// @return An EventId that can be further used for deregistration.
+        EventId connect(Callback callback) {
+            return add(std::move(callback), false);
+        }
+
+        /// @brief Registers a listener that is called only once.
+        /// @param callback The callback function.
+        /// @return An EventId that can be further used for deregistration.
+        EventId connectOnce(Callback callback) {
+            return add(std::move(callback), true);
+        }
+
+        /// @brief Calls all listeners.
+        /// @param args The arguments to pass to the listeners.
+        void fire(const std::decay_t<Args>&... args) {
+            if (listeners.empty()) return;
+
+            ++firing;
+            // Listeners connected from a callback are in pending, so this one can't be reallocated meanwhile
+            // Disconnected listeners are only erased once the outermost fire returns, as one may be running
+            for (auto& listener : listeners) {
+                if (!listener.alive) continue;
+                if (listener.once) {
+                    listener.alive = false;
+                    hasRemovals = true;
+                }
+                listener.callback(args...);
+            }
+            if (--firing == 0) flush();
+        }
+
+        /// @brief Deregisters a listener.
+        /// @param id The id received when connecting.
+        void disconnect(EventId id) override {
+            for (auto* list : { &listeners, &pending }) {
+                for (auto& listener : *list) {
+                    if (listener.id != id) continue;
+                    listener.alive = false;
+                    hasRemovals = true;
+                }
+            }
+            if (!firing) flush();
+        }
+
+        /// @brief Deregisters all listeners.
+        void reset() override {
+            for (auto& listener : listeners) listener.alive = false;
+            pending.clear();
+            hasRemovals = true;
+            if (!firing) flush();
+        }
+
+        /// @brief Returns whether the signal has no listener.
+        /// @return Whether it's empty.
+        [[nodiscard]] bool empty() const {
+            return listeners.empty() && pending.empty();
+        }
+
+        [[nodiscard]] const std::type_info& signature() const override {
+            return typeid(std::tuple<std::decay_t<Args>...>);
+        }
+
+        size_t connectErased(const void* callback, bool once) override {
+            const auto& erased = *static_cast<const std::function<void(const std::decay_t<Args>&...)>*>(callback);
+            return add(Callback(erased), once);
+        }
+
+        void fireErased(const void* args) override {
+            std::apply([this](const auto&... unpacked) { fire(unpacked...); },
+                *static_cast<const std::tuple<std::decay_t<Args>...>*>(args));
+        }
+
+    private:
+        struct Listener {
+            EventId id;
+            Callback callback;
+            bool once;
+            bool alive;
+        };
+
+        std::vector<Listener> listeners;
+        /// @brief Listeners connected while firing.
+        std::vector<Listener> pending;
+
+        EventId nextListenerId = 0;
+        /// @brief The depth of nested fire() calls.
+        int firing = 0;
+        /// @brief Whether some listeners have been disconnected but not erased yet.
+        bool hasRemovals = false;
+
+        EventId add(Callback callback, bool once) {
+            const EventId id = nextListenerId++;
+            (firing ? pending : listeners).push_back({ id, std::move(callback), once, true });
+            return id;
+        }
+
+        /// @brief Erases the disconnected listeners and appends the pending ones. Only called outside of fire().
+        void flush() {
+            if (hasRemovals) {
+                listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                    [](const Listener& listener) { return !listener.alive; }),
+                    listeners.end());
+                hasRemovals = false;
+            }
+            for (auto& listener : pending) {
+                if (listener.alive) listeners.push_back(std::move(listener));
+            }
+            pending.clear();
+        }
+    };
+}
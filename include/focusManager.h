@@ -0,0 +1,58 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    class GuiObject;
+
+    /// @brief Holds the object with the keyboard focus of a scene, the only one keyboard and text events are sent to.
+    /// Tab and Shift+Tab move the focus to the next and previous focusable objects, in tree order or in the order set with setTabOrder().
+    /// Text input is only turned on while the focused object accepts it, so the platform doesn't show an input method for nothing.
+    class FocusManager {
+    public:
+        /// @brief Gives the focus to an object, firing onFocusChange on the object losing it and on the one getting it.
+        /// @param obj The object. Can be nullptr to clear the focus.
+        void setFocus(const std::shared_ptr<GuiObject>& obj);
+
+        /// @brief Returns the object that has the focus.
+        /// @returns The object, or nullptr if there is none.
+        [[nodiscard]] std::shared_ptr<GuiObject> getFocused() const;
+
+        /// @brief Sends a keyboard or text event to the focused object, or moves the focus if it's a Tab it doesn't use.
+        /// @param e The event.
+        /// @param roots The root objects of the scene, walked for the tab order.
+        void dispatch(const SDL_Event& e, const std::vector<std::shared_ptr<GuiObject>>& roots);
+
+        /// @brief Moves the focus to the next focusable object, or to the first one if none has the focus.
+        /// Only visible and active objects with visible and active ancestors take it.
+        /// @param roots The root objects of the scene, walked when no tab order is set.
+        /// @param backwards Whether to move to the previous object instead.
+        /// @returns The object that got the focus, or nullptr if there is none to focus.
+        std::shared_ptr<GuiObject> moveFocus(const std::vector<std::shared_ptr<GuiObject>>& roots, bool backwards = false);
+
+        /// @brief Sets the order Tab goes through, instead of the tree order. Objects that are gone or can't take the focus are skipped.
+        /// @param order The objects, an empty list to go back to the tree order.
+        void setTabOrder(const std::vector<std::shared_ptr<GuiObject>>& order);
+
+        /// @brief Turns text input on or off, depending on whether the focused object accepts it.
+        /// Done when the scene is created or run, on every focus change and on keyboard events.
+        /// Call it after changing what the focused object accepts.
+        void refreshTextInput() const;
+
+    private:
+        std::weak_ptr<GuiObject> focused;
+        /// @brief The order set with setTabOrder(), empty for the tree order.
+        std::vector<std::weak_ptr<GuiObject>> tabOrder;
+        /// @brief Reused storage for the objects Tab goes through.
+        std::vector<GuiObject*> candidates;
+        /// @brief Reused storage for walking the trees.
+        std::vector<GuiObject*> stack;
+
+        /// @brief Returns whether an object and its ancestors are visible and active.
+        [[nodiscard]] static bool isReachable(const GuiObject& obj);
+
+        /// @brief Fills candidates with the objects Tab goes through, in order.
+        void collect(const std::vector<std::shared_ptr<GuiObject>>& roots);
+    };
+}
@@ -14,6 +14,12 @@ namespace GUILib {
 
         /// @brief The class name.
         static inline const std::string CLASS_NAME = "Frame";
+
+        /// @brief Renders the box of the frame, without the children.
+        void renderBox();
+
+        bool getTweenValue(TweenType type, double* values) const override;
+        void setTweenValue(TweenType type, const double* values) override;
         
         Frame(
             std::shared_ptr<GuiObject> parent,
@@ -53,8 +59,8 @@ namespace GUILib {
     };
 
     /// @brief A scrollable frame with handle support.
-    class ScrollingFrame final : public Frame {
-    private:
+    class ScrollingFrame : public Frame {
+    protected:
 
         /// @brief Full size of the scrollable content.
         UIUnit contentSize = UIUnit();               
@@ -80,13 +86,51 @@ namespace GUILib {
         
         SDL_Rect handleRectX, handleRectY;
 
+        /// @brief The rect of a child in content coordinates, which scrolling doesn't change.
+        struct ChildExtent {
+            int top, bottom, left, right;
+            /// @brief Where the child is in children, checked against object before use.
+            size_t index;
+            const GuiObject* object;
+        };
+
+        /// @brief The extents of the children, sorted by top.
+        std::vector<ChildExtent> childExtents;
+        /// @brief The largest bottom among childExtents[0..i], so the first child that can reach the viewport is found by binary search.
+        std::vector<int> maxBottoms;
+        /// @brief The childrenGeometryRevision and size the extents were built for.
+        std::uint64_t indexedGeometryRevision = 0;
+        SDL_Point indexedSize = { -1, -1 };
+        /// @brief The indices of the children intersecting the viewport, in render order. Reused every frame.
+        std::vector<size_t> visibleChildren;
+
+        /// @brief Rebuilds the child extents if a child changed, or if the frame was resized.
+        void refreshChildExtents(const SDL_Rect& rect);
+
+        /// @brief Fills visibleChildren, without resolving the layout of the children outside the viewport.
+        /// @returns False if the extents were out of date, they have to be rebuilt.
+        bool collectVisibleChildren(const SDL_Rect& rect);
+
+        /// @brief Brings the extents up to date and fills visibleChildren.
+        void updateVisibleChildren(const SDL_Rect& rect);
+
+        /// @brief Only lays out the children intersecting the viewport, the others are resolved when they scroll in.
+        void updateChildrenLayout() override;
+
         /// @brief Updates the scrollbars.
         void updateScrollbars();
 
         /// @brief Scrolls the content.
         /// @param deltaX The change in X.
         /// @param deltaY The change in Y.
-        void scroll(int deltaX, int deltaY);
+        virtual void scroll(int deltaX, int deltaY);
+
+        /// @brief Children are shifted by the current scroll position.
+        /// @returns The scroll position.
+        [[nodiscard]] SDL_Point getContentOffset() const override;
+
+        bool getTweenValue(TweenType type, double* values) const override;
+        void setTweenValue(TweenType type, const double* values) override;
 
         /// @brief Renders the scrollbars.
         /// @param absContentSize The absolute content size of this (reference to contentSize).
@@ -142,7 +186,15 @@ namespace GUILib {
 
         /// @brief Handles the event for the object.
         /// @param event The event to be passed.
-        void handleEvent(const SDL_Event& event) override;
+        void processEvent(const SDL_Event& event) override;
+
+        /// @brief Children are clipped to the frame.
+        /// @returns Always true.
+        [[nodiscard]] bool clipsChildren() const override;
+
+        /// @brief Only the children intersecting the viewport, found the same way render() does.
+        /// @param callback The function.
+        void forEachChildInView(const std::function<void(GuiObject*)>& callback) override;
 
         /// @brief Gets the scrolling speed of this frame (px/ms).
         int getScrollingSpeed() const;
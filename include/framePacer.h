@@ -0,0 +1,35 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief Waits for the start of each frame at a fixed interval.
+        /// Sleeps most of the way and spins for the last part, which sleeping would overshoot.
+        /// Deadlines follow each other from the first one, so frames don't drift when the wait wakes up late.
+        class FramePacer {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            /// @brief Creates a pacer.
+            /// @param interval The time between frame starts, zero or less not to wait at all.
+            /// @param spinMargin The last part of the wait spent spinning.
+            FramePacer(Clock::duration interval, Clock::duration spinMargin);
+
+            /// @brief Starts counting from now, after a pause.
+            void reset();
+
+            /// @brief Waits until the next frame starts. Returns right away if it's already late,
+            /// and starts counting from now if it's more than a frame late.
+            void wait();
+
+        private:
+            Clock::duration interval;
+            Clock::duration spinMargin;
+            /// @brief The start of the next frame.
+            Clock::time_point deadline;
+        };
+    }
+}
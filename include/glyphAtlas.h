@@ -0,0 +1,164 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief Returns an index buffer covering at least quadCount quads, two triangles each.
+        /// Quads are four vertices: top left, top right, bottom right, bottom left.
+        /// @param quadCount The amount of quads.
+        /// @returns The indices.
+        const std::vector<int>& quadIndices(size_t quadCount);
+
+        /// @brief Decodes the UTF-8 code point starting at index, and moves index past it.
+        /// Invalid or truncated sequences decode to U+FFFD, one byte at a time.
+        /// @param str The string.
+        /// @param index The byte index of the code point, advanced to the next one.
+        /// @returns The code point.
+        Uint32 decodeUtf8(std::string_view str, size_t& index);
+
+        /// @brief A font-scoped cache of glyph advances and kerning, shared by every renderer.
+        class FontMetrics {
+        public:
+            /// @brief Returns the metrics associated with the font, creating them if needed.
+            /// @param font The font.
+            /// @returns The metrics.
+            static FontMetrics& get(TTF_Font* font);
+
+            /// @brief Drops the metrics (and the glyph atlases) of the font.
+            /// Must be called before closing the font, or when its size or style changes.
+            /// @param font The font.
+            static void releaseFont(TTF_Font* font);
+
+            /// @brief Returns the horizontal advance of a glyph.
+            /// @param codepoint The code point.
+            /// @returns The advance, in pixels.
+            [[nodiscard]] int advance(Uint32 codepoint);
+
+            /// @brief Returns the kerning adjustment between two glyphs.
+            /// @param previous The code point on the left.
+            /// @param codepoint The code point on the right.
+            /// @returns The adjustment, in pixels.
+            [[nodiscard]] int kerning(Uint32 previous, Uint32 codepoint);
+
+            /// @brief Measures a line of text, kerning included.
+            /// @param str The UTF-8 text.
+            /// @returns The width, in pixels.
+            [[nodiscard]] int measure(std::string_view str);
+
+            /// @brief Returns the height of the font.
+            [[nodiscard]] int height() const;
+
+            explicit FontMetrics(TTF_Font* font);
+
+            FontMetrics(const FontMetrics&) = delete;
+            FontMetrics& operator=(const FontMetrics&) = delete;
+
+        private:
+            TTF_Font* font;
+            bool kerningEnabled;
+            int fontHeight;
+
+            /// @brief Advances of the ASCII range, -1 when not measured yet.
+            int asciiAdvances[128];
+            std::unordered_map<Uint32, int> advances;
+            std::unordered_map<std::uint64_t, int> kernings;
+        };
+
+        /// @brief A renderer and font scoped atlas of glyph textures, shared by every text widget.
+        /// Glyphs are rendered white, once, and packed into pages on first use; the text color comes from the vertices.
+        class GlyphAtlas {
+        public:
+            /// @brief A glyph packed in the atlas.
+            struct Glyph {
+                /// @brief The index of the page holding the glyph, -1 for glyphs with nothing to draw.
+                int page = -1;
+                /// @brief The area of the glyph in the page.
+                SDL_Rect source {};
+                /// @brief The horizontal offset from the pen position to the left of the source.
+                int offsetX = 0;
+            };
+
+            /// @brief Returns the atlas associated with the renderer and the font, creating it if needed.
+            /// @param r The renderer.
+            /// @param font The font.
+            /// @returns The atlas.
+            static GlyphAtlas& get(SDL_Renderer* r, TTF_Font* font);
+
+            /// @brief Destroys every atlas of the renderer.
+            /// Must be called before destroying the renderer, or when its targets are reset.
+            /// @param r The renderer.
+            static void releaseRenderer(SDL_Renderer* r);
+
+            /// @brief Destroys every atlas of the font.
+            /// @param font The font.
+            static void releaseFont(TTF_Font* font);
+
+            /// @brief Returns a glyph, rendering and packing it if needed.
+            /// @param codepoint The code point.
+            /// @returns The glyph.
+            const Glyph& glyph(Uint32 codepoint);
+
+            /// @brief Returns a page texture.
+            /// @param index The index of the page.
+            /// @returns The texture.
+            [[nodiscard]] SDL_Texture* page(int index) const;
+
+            /// @brief Returns the amount of pages.
+            [[nodiscard]] size_t pageCount() const;
+
+            /// @brief Returns an id unique to this atlas, so cached quads can tell a recreated atlas apart.
+            [[nodiscard]] std::uint64_t getId() const;
+
+            /// @brief Draws quads built from the pages of this atlas.
+            /// @param quads The vertices of each page, four per quad (top left, top right, bottom right, bottom left).
+            void draw(const std::vector<std::vector<SDL_Vertex>>& quads) const;
+
+            GlyphAtlas(SDL_Renderer* r, TTF_Font* font);
+            ~GlyphAtlas();
+
+            GlyphAtlas(const GlyphAtlas&) = delete;
+            GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+            /// @brief The size of a page, in pixels.
+            static constexpr int PAGE_SIZE = 512;
+
+        private:
+            SDL_Renderer* renderer;
+            TTF_Font* font;
+            std::uint64_t id;
+
+            std::vector<SDL_Texture*> pages;
+            /// @brief The shelf being filled in the last page.
+            int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+            /// @brief Glyphs of the ASCII range are looked up directly.
+            Glyph asciiGlyphs[128];
+            bool asciiLoaded[128] {};
+            std::unordered_map<Uint32, Glyph> glyphs;
+
+            /// @brief Renders and packs a glyph.
+            Glyph load(Uint32 codepoint);
+            /// @brief Finds room for a w * h area, adding a page if needed.
+            /// @returns Whether there is room. Fails for glyphs larger than a page.
+            bool allocate(int w, int h, int& page, SDL_Point& position);
+        };
+
+        /// @brief Appends the quad of a glyph, positioned at the pen.
+        /// @param quads The vertices of each page.
+        /// @param atlas The atlas the glyph belongs to.
+        /// @param glyph The glyph.
+        /// @param x The pen position.
+        /// @param y The top of the line.
+        /// @param color The color of the glyph.
+        void appendGlyphQuad(
+            std::vector<std::vector<SDL_Vertex>>& quads,
+            const GlyphAtlas& atlas,
+            const GlyphAtlas::Glyph& glyph,
+            float x, float y,
+            const SDL_Color& color
+        );
+    }
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "guiobject.h"
+#include "spatialIndex.h"
+#include "textureCache.h"
+#include "tweenScheduler.h"
+#include "focusManager.h"
 
 namespace GUILib {
 
@@ -28,6 +32,48 @@ namespace GUILib {
     }
 
 
+    /// @brief The settings of SceneManager::run().
+    struct RunOptions {
+        /// @brief The most frames drawn per second. Zero or less to draw as fast as presenting allows, with vsync for instance.
+        double frameRate = 60.0;
+        /// @brief The duration of an update step, in seconds. Tweens always advance by this much, whatever the frame rate.
+        double updateStep = 1.0 / 120.0;
+        /// @brief The most update steps run per frame. Time beyond that is dropped, so a long stall doesn't snowball.
+        int maxUpdatesPerFrame = 8;
+        /// @brief The last part of the wait for the next frame spent spinning instead of sleeping, in seconds.
+        double spinMargin = 0.002;
+        /// @brief The longest wait for an event while the scene is idle, in milliseconds.
+        int maxIdleWait = 500;
+
+        /// @brief Called with every event, before the scene handles it.
+        std::function<void(const SDL_Event&)> onEvent;
+        /// @brief Called at every update step, after the tweens, with the step in seconds.
+        /// Not called while the scene is idle: call SceneManager::invalidate() to keep it running.
+        std::function<void(double)> onUpdate;
+        /// @brief Called after the scene is drawn, before presenting, for drawing on top of it.
+        std::function<void()> onRender;
+    };
+
+    /// @brief Frame times measured by SceneManager::run(), the frames waiting for events while idle aside.
+    struct FrameStats {
+        /// @brief The frames drawn, and the frames skipped because nothing changed.
+        std::uint64_t renderedFrames = 0, skippedFrames = 0;
+        /// @brief The update steps run.
+        std::uint64_t updates = 0;
+        /// @brief The times the loop waited for an event because nothing was going on.
+        std::uint64_t idleWaits = 0;
+        /// @brief The mouse motions merged into the next one instead of being handled.
+        std::uint64_t coalescedMotions = 0;
+        /// @brief The time from the start of the last frame to the start of the next one, in milliseconds.
+        double lastFrameMs = 0;
+        /// @brief The time the last frame spent on events, updates and drawing, without waiting, in milliseconds.
+        double lastWorkMs = 0;
+        /// @brief The same times averaged over the recent frames, in milliseconds.
+        double averageFrameMs = 0, averageWorkMs = 0;
+        /// @brief The longest frame, in milliseconds.
+        double worstFrameMs = 0;
+    };
+
     /// @brief A class to facilitate the scene rendering.
     /// @brief Might be useful for bulk rendering, and I don't recommend using this now.
     class SceneManager {
@@ -37,10 +83,89 @@ namespace GUILib {
         /// @brief The list of objects to render. (Only the references).
         std::vector<std::shared_ptr<GuiObject>> objects;
 
+        /// @brief The hit-test index over the objects of the scene.
+        Reserved::SpatialIndex index;
+        /// @brief Whether the index must be rebuilt regardless of the revision.
+        bool indexDirty = true;
+
+        /// @brief The renderer output size, queried once per frame by render().
+        SDL_Point outputSize {};
+        /// @brief Reused storage for the roots render() found resized.
+        std::vector<Reserved::NodeHandle> resizedRoots;
+
+        /// @brief The render revision the render list was recorded at.
+        std::uint64_t recordedRevision = 0;
+        /// @brief The renderer output size the render list was recorded at.
+        SDL_Point recordedOutputSize {};
+        /// @brief Whether the render list must be recorded again regardless of the revision.
+        bool renderDirty = true;
+
+        /// @brief Whether the scene is kept in the target texture, only drawing again the areas that changed.
+        bool damageTracking = false;
+        /// @brief The color behind the objects in the target texture.
+        SDL_Color backgroundColor { 0, 0, 0, 255 };
+        /// @brief The texture holding the scene when damage tracking is on.
+        Reserved::SharedTexture target;
+        /// @brief The size of the target texture.
+        SDL_Point targetSize {};
+
+        /// @brief Creates the target texture, or creates it again if the output size changed.
+        /// @returns Whether there is a target texture to draw into.
+        bool prepareTarget(const SDL_Point& outputSize);
+
+        /// @brief Draws the changed areas of the scene into the target texture, then copies it to the output.
+        void presentTarget();
+
+        /// @brief The object that received the last mouse button press, gets the pointer events until the release.
+        std::weak_ptr<GuiObject> captured;
+        /// @brief Tracks the object that receives the keyboard and text events.
+        FocusManager focus;
+        /// @brief The object chain under the pointer at the last motion, used to notify the objects left by the pointer.
+        std::vector<std::weak_ptr<GuiObject>> hoverChain;
+        /// @brief Reused storage for the chain an event is routed through.
+        std::vector<std::shared_ptr<GuiObject>> routeChain;
+        /// @brief The last known pointer position.
+        SDL_Point pointer { -1, -1 };
+        /// @brief Whether mouse motions waiting one after the other are merged, see setMotionCoalescing().
+        bool motionCoalescing = true;
+
+        /// @brief Returns whether the motions can be merged: no object under the pointer or holding it needs every one.
+        [[nodiscard]] bool canCoalesceMotion() const;
+
+        /// @brief Merges the mouse motions waiting right behind a motion into it.
+        void coalesceMotion(SDL_Event& e);
+
+        /// @brief The tweens of the scene, see getTweens().
+        TweenScheduler tweens;
+
+        /// @brief Whether run() keeps going.
+        bool running = false;
+        /// @brief The frame times measured by run().
+        FrameStats frameStats;
+
+        /// @brief Passes an event to the callback of run() and to the objects, stopping on SDL_QUIT.
+        void dispatchRunEvent(const SDL_Event& e, const RunOptions& options);
+
+        /// @brief Adds the times of a frame to the statistics.
+        void recordFrame(double frameMs, double workMs);
+
+        /// @brief The arena objects of the scene can be built in, see getArena().
+        std::shared_ptr<Reserved::NodeArena> arena = std::make_shared<Reserved::NodeArena>();
+
+        /// @brief Routes a mouse event to the target under the pointer (or the captured one) and its ancestors.
+        void dispatchPointerEvent(const SDL_Event& e);
+
+        /// @brief Fills routeChain with the object and all of its ancestors, the object first.
+        void buildRouteChain(const std::shared_ptr<GuiObject>& target);
+
+        /// @brief Brings the hit-test index up to date, rebuilding it only if the trees changed otherwise than by moving objects.
+        void refreshIndex();
+
     public:
         /// @brief Creates a scene manager.
+        /// Turns text input off, SDL starts with it on, until an object accepting text gets the focus.
         /// @param ref The renderer to use for the scene.
-        explicit SceneManager(SDL_Renderer* ref) : ref(ref) {}
+        explicit SceneManager(SDL_Renderer* ref) : ref(ref) { focus.refreshTextInput(); }
 
         /// @brief Adds an object to the scene.
         /// @param obj The object to add.
@@ -51,15 +176,108 @@ namespace GUILib {
             (check_shared_ptr_subclass<GuiObjects, GuiObject>(), ...);
 
             (objects.push_back(args), ...);
+            indexDirty = true;
+            renderDirty = true;
         }
 
         /// @brief Renders all objects in the scene.
+        /// Their draw commands are recorded into the render list of the renderer and submitted in batches.
+        /// When nothing changed since the last call, the recorded commands are submitted again without walking the objects.
         void render();
 
+        /// @brief Makes the next render() walk the objects again, for changes made outside of their setters.
+        void invalidate();
+
+        /// @brief Returns whether the next render() would draw something new: an object changed, or has to be laid out.
+        [[nodiscard]] bool needsRender() const;
+
+        /// @brief Advances the scene by a step: the tweens.
+        /// @param deltaTime The step, in seconds.
+        void update(double deltaTime);
+
+        /// @brief Runs the scene until stop() is called or SDL_QUIT comes in.
+        /// Events are handled, with the mouse motions merged like pollEvent() does, then the scene is updated in fixed steps and drawn, at most at the frame rate.
+        /// Frames where nothing changed aren't drawn, and while no tween is running either the loop sleeps until the next event.
+        /// Without damage tracking the output is cleared to the background color before drawing.
+        /// @param options The settings and callbacks.
+        void run(const RunOptions& options = {});
+
+        /// @brief Makes run() return after the current frame.
+        void stop();
+
+        /// @brief Returns the frame times measured by the last or current run().
+        [[nodiscard]] const FrameStats& getFrameStats() const;
+
+        /// @brief Returns the arena of the scene, for building its objects inside an ArenaScope.
+        /// The memory of the objects comes back once the scene manager and every object built in the arena are gone.
+        /// Suits objects living as long as the scene, objects built and dropped all the time would only make it grow.
+        /// @returns The arena.
+        [[nodiscard]] const std::shared_ptr<Reserved::NodeArena>& getArena() const;
+
+        /// @brief Returns the tweens of the scene, advanced together by calling update() on them once per frame.
+        /// @returns The scheduler.
+        [[nodiscard]] TweenScheduler& getTweens();
+
+        /// @brief Keeps the scene in a texture, so render() only draws the areas that changed since the last call.
+        /// The texture covers the whole output and is cleared to the background color, hiding whatever was drawn before render().
+        /// Renderers without render targets keep drawing everything.
+        /// The texture belongs to the renderer, turn tracking off or call updateRenderer(nullptr) before destroying the renderer.
+        /// @param value Whether to track the changed areas.
+        void setDamageTracking(bool value);
+
+        /// @brief Returns whether the changed areas are tracked, see setDamageTracking().
+        [[nodiscard]] bool isDamageTracking() const;
+
+        /// @brief Sets the color behind the objects when damage tracking is on.
+        /// @param color The color.
+        void setBackgroundColor(const SDL_Color& color);
+
+        /// @brief Returns the color behind the objects when damage tracking is on.
+        [[nodiscard]] SDL_Color getBackgroundColor() const;
+
         /// @brief Handles all event for objects.
+        /// Pointer events are only passed to the object under the pointer and its ancestors,
+        /// keyboard and text events only to the focused object, Tab moving the focus. Window resizes are left to the next render(),
+        /// which lays the scene out once for the whole burst. Other events are passed to every object.
         /// @param e The event to be handled.
         void handleEvent(const SDL_Event& e);
 
+        /// @brief Takes the next event, like SDL_PollEvent(). Mouse motions waiting one after the other are merged into the last one,
+        /// with the relative motions added up, so a fast mouse costs one motion per frame. Use it in loops calling handleEvent().
+        /// @param e The event taken.
+        /// @returns Whether there was an event.
+        bool pollEvent(SDL_Event& e);
+
+        /// @brief Sets whether pollEvent() and run() merge the mouse motions waiting one after the other. On by default.
+        /// Motions are never merged while an object under the pointer or holding it returns true from GuiObject::needsEveryMotion().
+        /// @param value Whether to merge them.
+        void setMotionCoalescing(bool value);
+
+        /// @brief Returns whether the mouse motions are merged, see setMotionCoalescing().
+        [[nodiscard]] bool isMotionCoalescing() const;
+
+        /// @brief Finds the topmost visible and active object under the point.
+        /// @param point The point, in renderer coordinates.
+        /// @returns The object, or nullptr if there is none.
+        [[nodiscard]] std::shared_ptr<GuiObject> hitTest(const SDL_Point& point);
+
+        /// @brief Gives the keyboard focus to the object.
+        /// @param obj The object. Can be nullptr to clear the focus.
+        void setFocus(const std::shared_ptr<GuiObject>& obj);
+
+        /// @brief Returns the object that has the keyboard focus.
+        /// @returns The object, or nullptr if there is none.
+        [[nodiscard]] std::shared_ptr<GuiObject> getFocused() const;
+
+        /// @brief Moves the keyboard focus to the next focusable object of the scene, like Tab does.
+        /// @param backwards Whether to move to the previous object instead, like Shift+Tab.
+        /// @returns The object that got the focus, or nullptr if there is none to focus.
+        std::shared_ptr<GuiObject> moveFocus(bool backwards = false);
+
+        /// @brief Returns the focus manager of the scene, for setting the tab order.
+        /// @returns The focus manager.
+        [[nodiscard]] FocusManager& getFocusManager();
+
         /// @brief Clears the scene.
         /// @param obj The object to clear.
         void clear(std::shared_ptr<GuiObject> obj);
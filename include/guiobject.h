@@ -2,6 +2,8 @@
 
 #include "types.h"
 #include "event.h"
+#include "nodeArena.h"
+#include "layoutStore.h"
 
 namespace GUILib {
 
@@ -11,6 +13,10 @@ namespace GUILib {
 		double clamp(double val, double min, double max);
 		/// helper function to check whether the point is in the rect
 		bool isPointInRect(const SDL_Point& point, const SDL_Rect& rect);
+		/// helper function to get the pointer position carried by mouse motion/button/wheel events
+		/// wheel events from SDL before 2.26 get the position of the last pointer event passed here
+		/// @returns Whether the event carries a pointer position
+		bool getEventPointer(const SDL_Event& event, SDL_Point& out);
 		/// creates box texture
 		[[nodiscard]]
 		TextureType createSolidBoxTexture(SDL_Renderer* r, SDL_Color c, int w, int h);
@@ -23,6 +29,12 @@ namespace GUILib {
 		/// @returns A pair of rotated positions
 		[[nodiscard]]
         std::pair<float, float> rotatePoint(float px, float py, float ox, float oy, float angle_rad);
+
+		/// helper function to read a color as the 4 values of a tween: r, g, b and a
+		void colorToTween(const SDL_Color& color, double* values);
+		/// helper function to turn the 4 values of a tween back into a color, rounded and clamped to [0, 255]
+		[[nodiscard]]
+		SDL_Color tweenToColor(const double* values);
     }
 
 	/// @brief A struct to represent the size of a GUI object.
@@ -46,8 +58,10 @@ namespace GUILib {
 	/// @brief Can be used as a base for all GUI objects.
 	class GuiObject : public std::enable_shared_from_this<GuiObject> {
 	protected:
-		/// @brief The rect of the object.
-		SDL_Rect objRect;
+		/// @brief The rect of the object. Cached by the layout pass, a copy of the one in the layout store.
+		mutable SDL_Rect objRect;
+		/// @brief The slot of the object in the layout store, holding its placement.
+		Reserved::NodeHandle node;
 		/// @brief The reference to the renderer of the object. Stored internally.
 		SDL_Renderer* ref;
 		/// @brief The parent of the object.
@@ -57,11 +71,6 @@ namespace GUILib {
 		int dragOffsetX,
 			dragOffsetY;
 
-		/// @brief The position of the object.
-		UIUnit position;
-		/// @brief The size of the object.
-		UIUnit size;
-
 		/// @brief Whether the object is being dragged.
 		bool isDragging;
 		/// @brief Whether the object is visible/or active.
@@ -69,12 +78,142 @@ namespace GUILib {
 		/// @brief Whether the object can be dragged.
 		bool canBeDragged;
 
-		/// @brief The event emitter of the object.
+		/// @brief The event emitter of the object. Only holds the events that have no typed signal.
 		EventEmitter events;
 
+		/// @brief Returns the typed signal backing a named event, so on() and trigger() can reach it.
+		/// Derived classes that declare signals must override it and fall back to their base.
+		/// @param eventName The name of the event.
+		/// @returns The signal, or nullptr if the event has none.
+		virtual Reserved::SignalBase* findSignal(std::string_view eventName);
+
+		/// @brief Reads a property a tween drives, for the properties that depend on the class: see TweenType.
+		/// Colors are read as r, g, b and a, the scroll position as x and y, the alpha as a single value.
+		/// Derived classes that have such properties must override it together with setTweenValue() and fall back to their base.
+		/// @param type The property.
+		/// @param values Set to the value, up to 4 doubles.
+		/// @returns Whether the object has the property.
+		virtual bool getTweenValue(TweenType type, double* values) const;
+
+		/// @brief Writes a property read by getTweenValue(), at every step of a tween.
+		/// @param type The property.
+		/// @param values The value, as read by getTweenValue().
+		virtual void setTweenValue(TweenType type, const double* values);
+
 		/// @brief Updates the object, the position and size.
+		/// Only recomputes the layout if it was invalidated, or if the output size of a root object changed.
 		void update(SDL_Renderer* renderer);
 
+		/// @brief Marks the layout of this object and all of its descendants as out of date.
+		/// If an object's layout is out of date, the layout of every descendant is out of date as well.
+		void invalidateLayout();
+
+		/// @brief Marks the layout of all descendants as out of date, keeping this object's.
+		/// Also picks up the content offset.
+		void invalidateChildrenLayout();
+
+		/// @brief Picks up a new content offset, marking out of date only the children laid out with the old one.
+		/// The others are out of date already, so a scroll costs about as much as the children in view.
+		void invalidateContentOffset();
+
+		/// @brief Recomputes the cached layout if it's out of date, resolving the ancestors first.
+		void resolveLayout() const;
+
+		friend class Reserved::LayoutStore;
+		/// @brief Called by the layout store when the rect of the object changed.
+		/// @param previous The rect before.
+		/// @param current The rect now.
+		void applyLayout(const SDL_Rect& previous, const SDL_Rect& current) const;
+
+		/// @brief Runs the layout pass on the children, called by updateLayout().
+		/// Containers may skip children that don't need their layout right away, getRect() still resolves them on demand.
+		virtual void updateChildrenLayout();
+
+		/// @brief Invalidates the layout of a root object if the output size of the renderer changed.
+		/// @returns Whether it changed.
+		bool refreshOutputSize();
+
+		/// @brief Sets the output size a root object is laid out against, invalidating its layout if it changed.
+		/// Does nothing for objects with a parent.
+		/// @param outputSize The size, in pixels.
+		/// @returns Whether it changed.
+		bool setOutputSize(const SDL_Point& outputSize);
+
+		/// @brief Lays out the objects whose layout is out of date in some trees, a tree level at a time.
+		/// @param roots The layout store handles of the root objects.
+		static void resolveLayouts(const std::vector<Reserved::NodeHandle>& roots);
+
+		friend class SceneManager;
+		friend class TweenScheduler;
+		/// @brief The renderer of the SceneManager being rendered, nullptr outside of SceneManager::render().
+		/// Its roots were handed the output size of the frame, so it isn't queried again for each of them.
+		static inline SDL_Renderer* sceneRenderer = nullptr;
+
+		/// @brief The counter returned by getTreeRevision().
+		static inline std::uint64_t treeRevision = 0;
+
+		/// @brief Counts the changes of appearance, the tree revision aside. See getRenderRevision().
+		static inline std::uint64_t renderRevision = 0;
+		/// @brief The earliest time passed to invalidateRenderAt() that hasn't been reached yet.
+		static inline std::chrono::steady_clock::time_point renderDeadline = std::chrono::steady_clock::time_point::max();
+
+		/// @brief Changes every time a child is moved, resized, added or removed.
+		/// Lets containers keep data derived from the placement of their children, the content offset aside.
+		std::uint64_t childrenGeometryRevision;
+
+		/// @brief Bumps the childrenGeometryRevision of the parent, if any.
+		void notifyParentGeometry() const;
+
+		/// @brief Bumps the tree revision and makes the hit-test indexes holding the object stale.
+		/// For changes of visibility, activity, parent, or of which children are in view.
+		void invalidateTree() const;
+
+		/// @brief Marks an area of the object as changed on screen, turned like the object is.
+		/// @param area The area, in renderer coordinates.
+		void damageArea(const SDL_Rect& area) const;
+
+		/// @brief Marks the areas of the object and all of its descendants as changed on screen.
+		void damageSubtree() const;
+
+		/// @brief Marks the cached textures of the caching ancestors, and of the object itself if asked, as out of date.
+		/// @param includeSelf Whether the cached texture of the object is out of date too.
+		void invalidateCache(bool includeSelf) const;
+
+		/// @brief Draws the object and its descendants into the cached texture if it's out of date.
+		/// @returns Whether the cached texture can be drawn.
+		bool refreshCache();
+
+		/// @brief Whether the subtree is drawn through cacheTexture.
+		bool cacheAsBitmap = false;
+		/// @brief Whether cacheTexture no longer shows the subtree.
+		mutable bool cacheDirty = true;
+		/// @brief The subtree drawn upright, as large as the object.
+		std::shared_ptr<SDL_Texture> cacheTexture;
+		/// @brief The cacheGeneration cacheTexture was drawn at.
+		std::uint64_t cachedGeneration = 0;
+
+		/// @brief Bumped by invalidateCaches(), every cached texture drawn before is lost.
+		static inline std::uint64_t cacheGeneration = 0;
+		/// @brief Whether any object ever cached its subtree, spares walking the ancestors otherwise.
+		static inline bool anyCache = false;
+
+		/// @brief Returns where an object is within the content of its parent, scrolling aside, without laying it out.
+		/// The parent must be laid out.
+		/// @param obj The object.
+		/// @returns The rect, relative to the parent.
+		[[nodiscard]] static SDL_Rect getContentRect(const GuiObject& obj);
+
+		/// @brief The offset applied to the position of every child, used for scrolling.
+		/// Overrides must call invalidateContentOffset() when it changes.
+		/// @returns The offset, in pixels.
+		[[nodiscard]] virtual SDL_Point getContentOffset() const;
+
+		friend class FocusManager;
+		/// @brief Called by the focus manager when the object gets or loses the keyboard focus, before onFocusChange is fired.
+		/// Does nothing by default.
+		/// @param focused Whether the object has the focus now.
+		virtual void focusChanged(bool focused);
+
 		/// @brief The children of the object.
 		std::vector<std::shared_ptr<GuiObject>> children;
 
@@ -88,12 +227,6 @@ namespace GUILib {
 		/// @brief The class name.
 		static inline const std::string CLASS_NAME = "GuiObject";
 		
-		/// @brief Serves as the rotating center of the object.
-		UIUnit renderingPivotOffset;
-
-		/// @brief Rotation of the object clockwise, in degrees.
-		double degreeRotation;
-
 		/// @brief The name of the object.
 		std::string name;
 
@@ -107,6 +240,31 @@ namespace GUILib {
 			bool isActive = true
 		);
 	public:
+		/// @brief Fired by move(), with the new position.
+		Signal<UIUnit> onPositionChange;
+		/// @brief Fired by resize(), with the new size.
+		Signal<UIUnit> onSizeChange;
+		/// @brief Fired while the object is dragged, with the pointer position.
+		Signal<int, int> onDragging;
+		/// @brief Fired by updateRenderer().
+		Signal<> onRendererUpdate;
+		/// @brief Fired by setVisible() and toggleVisibility().
+		Signal<> onVisibilityChange;
+		/// @brief Fired by setActive().
+		Signal<> onActiveChange;
+		/// @brief Fired by setParent(), with whether it succeeded.
+		Signal<bool> onParentChange;
+		/// @brief Fired by addChild(), with whether it succeeded.
+		Signal<bool> onChildAdded;
+		/// @brief Fired by removeChild(), with whether it succeeded.
+		Signal<bool> onChildRemoved;
+		/// @brief Fired by setRotation(), with the new rotation.
+		Signal<double> onRotationChange;
+		/// @brief Fired by setPivotOffset(), with the new offset.
+		Signal<UIUnit> onPivotOffsetChange;
+		/// @brief Fired by the focus manager of the scene, with whether the object got or lost the keyboard focus.
+		Signal<bool> onFocusChange;
+
 		// Default constructor. Not recommended to use.
 		GuiObject();
 		GuiObject(const GuiObject&) noexcept;
@@ -122,7 +280,8 @@ namespace GUILib {
 			std::shared_ptr<ProductType> obj;
 		public:
 
-			Builder() : obj(std::make_shared<ProductType>()) {}
+			/// @brief Creates the object, in the arena of the current ArenaScope if there is one.
+			Builder() : obj(Reserved::makeNode<ProductType>()) {}
 
 			/// @brief Sets the parent.
 			/// @param p The parent.
@@ -196,6 +355,15 @@ namespace GUILib {
 				return static_cast<DerivedBuilder&>(*this);
 			}
 
+			/// @brief Sets whether the subtree is cached into a texture, see GuiObject::setCacheAsBitmap().
+			/// @param val The value.
+			/// @returns The current modified builder.
+			virtual DerivedBuilder& setCacheAsBitmap(bool val)
+			{
+				obj->setCacheAsBitmap(val);
+				return static_cast<DerivedBuilder&>(*this);
+			}
+
 			/// @brief Finalizes the object.
 			/// @returns The final created object.
 			[[nodiscard]] virtual std::shared_ptr<ProductType> build() const
@@ -235,9 +403,14 @@ namespace GUILib {
 		bool removeChild(const std::shared_ptr<GuiObject>& child);
 
 		/// @brief Returns the rect of the object.
+		/// Resolves the layout first if it's out of date.
 		/// @return The rect of the object.
 		SDL_Rect getRect() const;
 
+		/// @brief Runs the layout pass on this object and every descendant with an out of date layout.
+		/// Subtrees that didn't change since the last pass are skipped entirely.
+		void updateLayout();
+
 		/// @brief Changes the pivot offset of the object.
 		/// Fires the "onPivotOffsetChange" event.
 		/// @param offset The new offset.
@@ -293,10 +466,86 @@ namespace GUILib {
 		/// @param value The new visibility state.
 		void setVisible(bool value);
 
-		/// @brief Handles the event for the object.
+		/// @brief Handles the event for the object, and all of its children.
+		/// Keyboard and text events are not passed to the children, the scene sends them to the focused object alone.
 		/// @param event The event that will be processed.
 		virtual void handleEvent(const SDL_Event& event);
 
+		/// @brief Handles the event for this object only, without passing it to the children.
+		/// Used by the scene to route events to the objects that are concerned by them.
+		/// @param event The event that will be processed.
+		virtual void processEvent(const SDL_Event& event);
+
+		/// @brief Whether the object can receive the keyboard focus.
+		/// @returns The value.
+		[[nodiscard]] virtual bool isFocusable() const;
+
+		/// @brief Whether the object takes text input while focused. The scene only turns text input on for such objects.
+		/// @returns The value.
+		[[nodiscard]] virtual bool acceptsTextInput() const;
+
+		/// @brief Whether the object uses the Tab key while focused, instead of the scene moving the focus with it.
+		/// Ctrl+Tab still moves the focus.
+		/// @returns The value.
+		[[nodiscard]] virtual bool handlesTab() const;
+
+		/// @brief Whether the object needs every mouse motion, instead of the motions of a frame merged into one.
+		/// Asked by the scene about the objects under the pointer or holding it, see SceneManager::setMotionCoalescing().
+		/// @returns The value.
+		[[nodiscard]] virtual bool needsEveryMotion() const;
+
+		/// @brief Whether the children are clipped to the rect of this object.
+		/// @returns The value.
+		[[nodiscard]] virtual bool clipsChildren() const;
+
+		/// @brief Calls a function with the children that may be in view, in drawing order, for hit testing and for the layout pass after a resize.
+		/// All of them by default. Containers knowing which children are out of sight skip those without laying them out.
+		/// @param callback The function.
+		virtual void forEachChildInView(const std::function<void(GuiObject*)>& callback);
+
+		/// @brief Returns the children of the object.
+		/// @returns The children.
+		[[nodiscard]] const std::vector<std::shared_ptr<GuiObject>>& getChildren() const;
+
+		/// @brief Returns a counter that changes every time the geometry, visibility or structure of any object changes.
+		/// Can be used to know when data derived from the object trees has to be rebuilt.
+		/// @returns The revision.
+		[[nodiscard]] static std::uint64_t getTreeRevision();
+
+		/// @brief Returns a counter that changes every time any object may look different.
+		/// Covers the tree revision, invalidateRender() calls and the times passed to invalidateRenderAt().
+		/// @returns The revision.
+		[[nodiscard]] static std::uint64_t getRenderRevision();
+
+		/// @brief Marks the object as looking different, so a retained rendering of it is drawn again.
+		/// Setters already do it, custom objects call it when their own state changes how they look.
+		void invalidateRender();
+
+		/// @brief Renders the object and its descendants, from the cached texture when caching is on.
+		/// Containers call it on their children rather than render().
+		void draw();
+
+		/// @brief Renders the object and its descendants once into a texture, then draws that texture until something in the subtree changes.
+		/// The rotation and pivot offset apply to the texture, turning the subtree as a whole. Descendants are clipped to the object.
+		/// The texture belongs to the renderer, turn caching off before destroying the renderer.
+		/// @param value Whether to cache the subtree.
+		void setCacheAsBitmap(bool value);
+
+		/// @brief Returns whether the subtree is cached, see setCacheAsBitmap().
+		[[nodiscard]] bool isCachedAsBitmap() const;
+
+		/// @brief Marks every cached texture as lost, for when the render targets of the renderer were reset.
+		static void invalidateCaches();
+
+		/// @brief Marks the area the object covers as changed on screen, without recording the scene again.
+		/// invalidateRender() already does it, this is for changes made while rendering.
+		void damage() const;
+
+		/// @brief Makes the render revision change once the time is reached, for objects animated by time.
+		/// The object calls damage() once it looks different, so only its area is drawn again.
+		/// @param time The time.
+		static void invalidateRenderAt(std::chrono::steady_clock::time_point time);
+
 		/// @brief Returns the parent of the object.
 		/// @return The parent of the object.
 		const std::weak_ptr<GuiObject>& getParent() const;
@@ -322,25 +571,43 @@ namespace GUILib {
 		virtual void render() = 0;
 
 		/// @brief Connects a callback to an event.
+		/// Built-in events are backed by typed signals (like onPositionChange), connecting to them directly is cheaper.
 		/// @param eventName The name of the event.
 		/// @param callback The callback function. Must contain the same arguments as the trigger function.
+		/// @throws std::runtime_error If the event is a built-in one taking other arguments.
 		template <typename... Args>
 		void on(
 			const std::string& eventName,
 			std::function<void(Args...)> callback
 		) {
 			// can't hide the implementation as this is a template function
+			if (auto* signal = findSignal(eventName)) {
+				// Nothing fires the named event any more, a callback of another signature would never run
+				if (signal->signature() != typeid(std::tuple<std::decay_t<Args>...>))
+					throw std::runtime_error("Event argument mismatch for " + eventName + "!");
+				const std::function<void(const std::decay_t<Args>&...)> erased = std::move(callback);
+				signal->connectErased(&erased, false);
+				return;
+			}
 			events.connect(eventName, std::move(callback));
 		}
 
 		/// @brief Triggers an event.
 		/// @param eventName The name of the event.
 		/// @param args The arguments that will be fired with the event. See EventEmitter for more details.
+		/// @throws std::runtime_error If the event is a built-in one taking other arguments.
 		template <typename... Args>
 		void trigger(
 			const std::string& eventName,
 			Args&&... args
 		) {
+			if (auto* signal = findSignal(eventName)) {
+				if (signal->signature() != typeid(std::tuple<std::decay_t<Args>...>))
+					throw std::runtime_error("Event argument mismatch for " + eventName + "!");
+				const std::tuple<std::decay_t<Args>...> packed(std::forward<Args>(args)...);
+				signal->fireErased(&packed);
+				return;
+			}
 			events.fire(eventName, std::forward<Args>(args)...);
 		}
 
@@ -5,6 +5,7 @@
 
 #include "types.h"
 #include "guiobject.h"
+#include "textureCache.h"
 
 
 namespace GUILib {
@@ -12,12 +13,22 @@ namespace GUILib {
 	/// @brief Texture wrapper, but with more features.
 	class Image : public GuiObject {
 	protected:
-		/// @brief The texture of the image.
-		SDL_Texture* imageTexture;
+		/// @brief The texture of the image, shared with the other objects showing the same file.
+		Reserved::TextureRegion imageTexture;
 		/// @brief The file path of the image.
 		std::string filePath;
 		/// @brief The previous file path of the image.
 		std::string prevFilePath;
+		/// @brief The color drawn while the file is decoding, nothing is drawn without it.
+		std::optional<SDL_Color> placeholderColor;
+		/// @brief Whether files are decoded on a worker thread.
+		bool asyncLoading = true;
+		/// @brief Whether the file is being decoded.
+		bool loading = false;
+		/// @brief Whether the file couldn't be loaded, it isn't tried again until the path changes.
+		bool loadFailed = false;
+		/// @brief Called back by the cache once the file is decoded, expired when nothing is waited on.
+		std::weak_ptr<Reserved::TextureCache::Waiter> loadWaiter;
 		
 		Image(
 			std::shared_ptr<GuiObject> parent,
@@ -26,7 +37,23 @@ namespace GUILib {
 			UIUnit position = UIUnit(),
 			std::string filePath = ""
 		);
+
+		/// @brief Takes the texture if the worker is done decoding the file, or waits to be called back when it is.
+		void pollTexture();
+
+		/// @brief Stops the cache from calling back for the file being decoded.
+		void stopWaiting();
+
+		/// @brief Reports the outcome of a load, once the texture is known.
+		void finishLoading();
+
+		Reserved::SignalBase* findSignal(std::string_view eventName) override;
 	public:
+		/// @brief Fired by updatePath(), with the new path.
+		Signal<const std::string&> onPathChange;
+		/// @brief Fired when the texture of the file is ready to be drawn.
+		Signal<> onLoaded;
+
 		Image();
 
 		class Builder final : public GuiObject::Builder<Builder, Image> {};
@@ -43,6 +70,27 @@ namespace GUILib {
 			const std::string& filePath
 		);
 
+		/// @brief Sets the color drawn until the file is ready.
+		/// @param color The color.
+		void setPlaceholderColor(const SDL_Color& color);
+
+		/// @brief Draws nothing until the file is ready.
+		void clearPlaceholderColor();
+
+		/// @brief Returns the color drawn until the file is ready, if any.
+		[[nodiscard]] std::optional<SDL_Color> getPlaceholderColor() const;
+
+		/// @brief Sets whether files are decoded on a worker thread, on by default.
+		/// When off, loading a file blocks until it is decoded.
+		/// @param value Whether to decode asynchronously.
+		void setAsyncLoading(bool value);
+
+		/// @brief Returns whether files are decoded on a worker thread.
+		[[nodiscard]] bool isAsyncLoading() const;
+
+		/// @brief Returns whether the texture of the file is ready to be drawn.
+		[[nodiscard]] bool isLoaded() const;
+
 		/// @brief Returns the previous file path.
 		/// @return The previous file path.
 		std::string previousFilePath() const;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "types.h"
+#include "textureCache.h"
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief Packs rectangles in a square area, each one as low as possible along the skyline of the previous ones.
+        class SkylinePacker {
+        public:
+            /// @param size The width and height of the area.
+            explicit SkylinePacker(int size);
+
+            /// @brief Finds room for a w * h rectangle.
+            /// @param w The width.
+            /// @param h The height.
+            /// @param position Set to the top left of the rectangle.
+            /// @returns Whether there was room.
+            bool insert(int w, int h, SDL_Point& position);
+
+            /// @brief Empties the area.
+            void reset();
+
+            /// @brief Returns the width and height of the area.
+            [[nodiscard]] int getSize() const;
+
+        private:
+            /// @brief A horizontal piece of the skyline, the area below it is taken.
+            struct Segment {
+                int x, y, width;
+            };
+
+            int size;
+            /// @brief Sorted by x, covering the whole width.
+            std::vector<Segment> skyline;
+
+            /// @brief Returns the lowest top a w * h rectangle starting at the segment can have, -1 if it doesn't fit.
+            [[nodiscard]] int fit(size_t index, int w, int h) const;
+        };
+
+        /// @brief A renderer-scoped set of pages holding small images, so consecutive draws of them share a texture.
+        /// Images are never removed from a page, a full atlas just stops taking new ones.
+        class ImageAtlas {
+        public:
+            /// @brief Returns the atlas associated with the renderer, creating it if needed.
+            /// @param r The renderer.
+            /// @returns The atlas.
+            static ImageAtlas& get(SDL_Renderer* r);
+
+            /// @brief Forgets the pages of the renderer. Pages still in use live on with their owners.
+            /// Must be called before destroying the renderer, or when its device is reset.
+            /// @param r The renderer.
+            static void releaseRenderer(SDL_Renderer* r);
+
+            /// @brief Copies an image into a page.
+            /// @param surface The image, left untouched.
+            /// @returns The area of the page holding the image, empty if the image is too large or the atlas is full.
+            [[nodiscard]] TextureRegion pack(SDL_Surface* surface);
+
+            /// @brief Returns the amount of pages.
+            [[nodiscard]] size_t pageCount() const;
+
+            explicit ImageAtlas(SDL_Renderer* r);
+
+            ImageAtlas(const ImageAtlas&) = delete;
+            ImageAtlas& operator=(const ImageAtlas&) = delete;
+
+            /// @brief The size of a page, in pixels.
+            static constexpr int PAGE_SIZE = 1024;
+            /// @brief The largest width or height of a packed image, in pixels.
+            static constexpr int MAX_IMAGE_SIZE = 128;
+            /// @brief The most pages an atlas creates.
+            static constexpr size_t MAX_PAGES = 4;
+
+        private:
+            struct Page {
+                SharedTexture texture;
+                SkylinePacker packer;
+            };
+
+            SDL_Renderer* renderer;
+            std::vector<Page> pages;
+        };
+    }
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "types.h"
+#include "unitResolve.h"
+
+namespace GUILib {
+
+    class GuiObject;
+
+    namespace Reserved {
+
+        /// @brief Identifies the slot of an object in the LayoutStore. Stays the same for the lifetime of the object.
+        /// Carries no generation: once the object is gone, the slot may be handed to another one.
+        using NodeHandle = std::uint32_t;
+
+        /// @brief The handle of no object, the parent of root objects.
+        inline constexpr NodeHandle INVALID_NODE = UINT32_MAX;
+
+        /// @brief Holds the placement of every object as a structure of arrays, one slot per object.
+        /// The layout pass reads and writes the arrays by handle, walking up through parent handles
+        /// instead of the objects, which are only called back when their rect changes.
+        /// Slots of destroyed objects are reused. Not thread safe, objects live on the thread owning the renderer.
+        class LayoutStore {
+        public:
+            /// @brief Returns the store. It lives until the process ends, so objects destroyed at exit can still free their slot.
+            static LayoutStore& get();
+
+            /// @brief Takes a slot for an object, a root with an out of date layout.
+            /// @param owner The object, called back when its rect changes.
+            /// @returns The handle of the slot.
+            [[nodiscard]] NodeHandle create(GuiObject* owner);
+
+            /// @brief Frees the slot of an object. Its children become roots.
+            /// @param node The handle.
+            void destroy(NodeHandle node);
+
+            /// @brief Hands a slot to another object, when the object is moved.
+            void setOwner(NodeHandle node, GuiObject* owner);
+
+            /// @brief Copies the placement and the parent of an object into another slot, marking its layout out of date.
+            /// @param from The handle copied.
+            /// @param to The handle written.
+            void copy(NodeHandle from, NodeHandle to);
+
+            /// @brief Sets the parent of an object, moving it to the children of the parent.
+            /// @param node The handle.
+            /// @param parent The handle of the parent, INVALID_NODE for a root.
+            void setParent(NodeHandle node, NodeHandle parent);
+
+            /// @brief Returns the handle of the parent, INVALID_NODE for a root.
+            [[nodiscard]] NodeHandle getParent(NodeHandle node) const;
+
+            /// @brief Returns the handle of the topmost ancestor, or of the object itself for a root.
+            [[nodiscard]] NodeHandle getRoot(NodeHandle node) const;
+
+            void setPosition(NodeHandle node, double x, double y, bool scaled);
+            void setSize(NodeHandle node, double x, double y, bool scaled);
+            void setPivot(NodeHandle node, double x, double y, bool scaled);
+            void setRotation(NodeHandle node, double degrees);
+
+            /// @brief Sets the offset applied to the position of every child, used for scrolling.
+            /// Only the children laid out since the last change are marked out of date, the others already are.
+            /// The first change marks every child, objects are only kept track of once they scroll.
+            /// @returns Whether it changed.
+            bool setContentOffset(NodeHandle node, const SDL_Point& offset);
+
+            /// @brief Sets the renderer output size a root is laid out against.
+            /// @returns Whether it changed.
+            bool setOutputSize(NodeHandle node, const SDL_Point& outputSize);
+
+            /// @brief Marks the layout of an object as out of date.
+            /// @returns Whether it was up to date.
+            bool markDirty(NodeHandle node);
+
+            /// @brief Marks the layout of all descendants of an object as out of date, skipping the subtrees that already are.
+            void markChildrenDirty(NodeHandle node);
+
+            /// @brief Lets an object and its ancestors know that the layout pass has to come down to some descendant.
+            void markDescendantsDirty(NodeHandle node);
+
+            /// @brief Lets the ancestors of an object know that the layout pass has to come down to it.
+            void markAncestors(NodeHandle node);
+
+            /// @brief Clears the mark set by markDescendantsDirty().
+            /// @returns Whether it was set.
+            bool clearDescendantsDirty(NodeHandle node);
+
+            /// @brief Returns whether the layout of an object is out of date.
+            [[nodiscard]] bool isDirty(NodeHandle node) const;
+
+            /// @brief Returns whether the layout of an object or of some descendant is out of date.
+            [[nodiscard]] bool needsLayout(NodeHandle node) const;
+
+            /// @brief Recomputes the layout of an object if it's out of date, resolving the ancestors first.
+            /// Objects whose rect changed are called back.
+            /// @returns Whether the object was out of date.
+            bool resolve(NodeHandle node);
+
+            /// @brief Recomputes the layout of the objects that are out of date in some trees, one tree level at a time,
+            /// placing the objects of a level together with resolveUnits(). Faster than resolve() when most objects are out of date.
+            /// Only walks down the subtrees that need it. Below the objects clipping their children, only the children
+            /// they report in view are walked, the others stay out of date until something asks for their rect.
+            /// @param roots The root objects of the trees.
+            /// @returns The amount of objects laid out.
+            size_t resolveDirty(const std::vector<NodeHandle>& roots);
+
+            /// @brief Returns the object holding a slot, nullptr for a free slot.
+            [[nodiscard]] GuiObject* getOwner(NodeHandle node) const { return owners[node]; }
+
+            [[nodiscard]] double getPositionX(NodeHandle node) const { return positionX[node]; }
+            [[nodiscard]] double getPositionY(NodeHandle node) const { return positionY[node]; }
+            [[nodiscard]] bool isPositionScaled(NodeHandle node) const { return flags[node] & POSITION_SCALED; }
+            [[nodiscard]] double getSizeX(NodeHandle node) const { return sizeX[node]; }
+            [[nodiscard]] double getSizeY(NodeHandle node) const { return sizeY[node]; }
+            [[nodiscard]] bool isSizeScaled(NodeHandle node) const { return flags[node] & SIZE_SCALED; }
+            [[nodiscard]] double getPivotX(NodeHandle node) const { return pivotX[node]; }
+            [[nodiscard]] double getPivotY(NodeHandle node) const { return pivotY[node]; }
+            [[nodiscard]] bool isPivotScaled(NodeHandle node) const { return flags[node] & PIVOT_SCALED; }
+            [[nodiscard]] double getRotation(NodeHandle node) const { return rotations[node]; }
+            [[nodiscard]] const SDL_Point& getOutputSize(NodeHandle node) const { return outputSizes[node]; }
+
+            /// @brief Returns where an object is within the content of its parent, from its position and size alone, without laying it out.
+            /// The parent must be up to date.
+            [[nodiscard]] SDL_Rect getContentRect(NodeHandle node) const;
+
+            /// @brief Returns the rect computed by the last layout pass, which may be out of date.
+            [[nodiscard]] const SDL_Rect& getRect(NodeHandle node) const { return rects[node]; }
+
+            /// @brief Returns the amount of slots in use.
+            [[nodiscard]] size_t size() const;
+
+            LayoutStore() = default;
+            LayoutStore(const LayoutStore&) = delete;
+            LayoutStore& operator=(const LayoutStore&) = delete;
+
+        private:
+            enum : std::uint8_t {
+                LAYOUT_DIRTY = 1 << 0,
+                DESCENDANTS_DIRTY = 1 << 1,
+                POSITION_SCALED = 1 << 2,
+                SIZE_SCALED = 1 << 3,
+                PIVOT_SCALED = 1 << 4,
+                /// @brief The object is in the laidOutChildren of its parent.
+                LAID_OUT_TRACKED = 1 << 5,
+                /// @brief The object keeps its children laid out with the current content offset in laidOutChildren.
+                TRACKS_LAID_OUT = 1 << 6
+            };
+
+            std::vector<NodeHandle> parents;
+            /// @brief The children of an object, linked through their siblings. In no particular order.
+            std::vector<NodeHandle> firstChildren, nextSiblings, previousSiblings;
+            std::vector<GuiObject*> owners;
+            std::vector<std::uint8_t> flags;
+
+            std::vector<double> positionX, positionY;
+            std::vector<double> sizeX, sizeY;
+            std::vector<double> pivotX, pivotY;
+            std::vector<double> rotations;
+            std::vector<SDL_Point> contentOffsets;
+            std::vector<SDL_Point> outputSizes;
+
+            /// @brief The absolute position and size, before being rounded into rects.
+            std::vector<double> layoutX, layoutY, layoutW, layoutH;
+            std::vector<SDL_Rect> rects;
+
+            /// @brief For the objects that scrolled, the children laid out since the content offset last changed.
+            /// Every other child is out of date, so a new offset only has to mark these.
+            std::unordered_map<NodeHandle, std::vector<NodeHandle>> laidOutChildren;
+
+            /// @brief Slots freed and not reused yet.
+            std::vector<NodeHandle> freeSlots;
+            /// @brief Reused storage for walking subtrees.
+            std::vector<NodeHandle> stack;
+
+            /// @brief The objects of the tree level resolveDirty() is at, and of the next one.
+            std::vector<NodeHandle> level, nextLevel;
+            /// @brief Reused storage for the inputs and outputs of resolveUnits().
+            struct Gathered {
+                std::vector<NodeHandle> nodes;
+                std::vector<double> positionX, positionY, sizeX, sizeY;
+                std::vector<std::uint64_t> positionMask, sizeMask;
+                std::vector<double> parentX, parentY, parentW, parentH, offsetX, offsetY;
+                std::vector<double> x, y, w, h;
+                std::vector<int> rectX, rectY, rectW, rectH;
+
+                /// @brief Sizes every array for count objects.
+                void resize(size_t count);
+                /// @brief Points a batch to the arrays.
+                [[nodiscard]] UnitBatch batch();
+            } gathered;
+
+            /// @brief Computes the layout of an object whose parent is up to date.
+            void compute(NodeHandle node);
+
+            /// @brief Places a laid out object: stores the rect and calls the object back if it changed.
+            void place(NodeHandle node, const SDL_Rect& rect);
+
+            /// @brief Removes an object from the laidOutChildren of its parent, before it leaves it.
+            void untrackLaidOut(NodeHandle node);
+
+            /// @brief Lays out the objects gathered, whose parents are up to date.
+            void computeGathered(size_t count);
+        };
+    }
+}
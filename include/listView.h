@@ -0,0 +1,164 @@
+#pragma once
+
+#include "frame.h"
+
+namespace GUILib {
+
+    /// @brief A scrolling list that only creates views for the visible items.
+    /// Views are made by the item factory, then recycled and rebound to other items while scrolling,
+    /// so the amount of views depends on the size of the viewport rather than on the amount of items.
+    class ListView : public ScrollingFrame {
+    public:
+        /// @brief Creates a view. Called only when no recycled view is available.
+        using ItemFactory = std::function<std::shared_ptr<GuiObject>()>;
+        /// @brief Fills a view with the item at the index.
+        using ItemBinder = std::function<void(const std::shared_ptr<GuiObject>& view, size_t index)>;
+
+    protected:
+        ItemFactory factory;
+        ItemBinder binder;
+
+        /// @brief The amount of items.
+        size_t itemCount = 0;
+        /// @brief The height of a row, in pixels.
+        int itemHeight = 30;
+        /// @brief The amount of rows kept bound above and below the viewport.
+        int overscan = 2;
+
+        /// @brief The views of the items in [firstBound, firstBound + boundViews.size()), in order.
+        std::vector<std::shared_ptr<GuiObject>> boundViews;
+        size_t firstBound = 0;
+        /// @brief Hidden views waiting to be rebound.
+        std::vector<std::shared_ptr<GuiObject>> recycledViews;
+
+        /// @brief Whether every bound view has to be bound again, set when the items changed.
+        bool rebindAll = false;
+        /// @brief The viewport and scroll position the views were placed for.
+        SDL_Rect placedViewport {};
+        int placedScrollY = -1;
+
+        /// @brief The class name.
+        static inline const std::string CLASS_NAME = "ListView";
+
+        /// @brief Returns the amount of items per row.
+        /// @param viewportWidth The width of the viewport, in pixels.
+        [[nodiscard]] virtual int columnCount(int viewportWidth) const;
+
+        /// @brief Returns the size of an item view, in pixels.
+        /// @param viewportWidth The width of the viewport, in pixels.
+        [[nodiscard]] virtual SDL_Point cellSize(int viewportWidth) const;
+
+        /// @brief Sizes the content to the rows of items, and pulls the scroll position back in if the list shrank.
+        void refreshContentSize(const SDL_Rect& viewport, int columns, const SDL_Point& cell);
+
+        /// @brief Binds the views of the items around the viewport, recycling the ones that went out of it.
+        /// Does nothing when neither the items, the viewport nor the scroll position changed.
+        void syncViews();
+
+        /// @brief Binds the views for the viewport before laying them out, so the rows scrolled in are laid out in the same pass.
+        void updateChildrenLayout() override;
+
+        /// @brief Binds the views first, so the layout pass after a resize and the hit-test index get the rows now in view.
+        void forEachChildInView(const std::function<void(GuiObject*)>& callback) override;
+
+        /// @brief Binds the rows scrolled in right away, so they can be hit before the next frame.
+        void scroll(int deltaX, int deltaY) override;
+
+        /// @brief Takes a recycled view, or makes a new one.
+        /// @returns The view, nullptr if there is no factory.
+        std::shared_ptr<GuiObject> obtainView();
+
+        /// @brief Hides a view and keeps it for later.
+        void recycleView(std::shared_ptr<GuiObject> view);
+
+        /// @brief Moves a view to the cell of the item.
+        void placeView(const std::shared_ptr<GuiObject>& view, size_t index, int columns, const SDL_Point& cell) const;
+
+    public:
+        ListView();
+
+        class Builder final : public GuiObject::Builder<Builder, ListView> {};
+
+        /// @brief Sets the function creating the views.
+        /// Existing views are dropped.
+        /// @param itemFactory The factory.
+        void setItemFactory(ItemFactory itemFactory);
+
+        /// @brief Sets the function filling a view with an item.
+        /// @param itemBinder The binder.
+        void setItemBinder(ItemBinder itemBinder);
+
+        /// @brief Sets the amount of items. Every visible view is bound again.
+        /// @param count The amount.
+        void setItemCount(size_t count);
+
+        /// @brief Gets the amount of items.
+        [[nodiscard]] size_t getItemCount() const;
+
+        /// @brief Sets the height of a row.
+        /// @param height The height, in pixels.
+        void setItemHeight(int height);
+
+        /// @brief Gets the height of a row, in pixels.
+        [[nodiscard]] int getItemHeight() const;
+
+        /// @brief Sets the amount of rows bound above and below the viewport, so fast scrolling doesn't show empty rows.
+        /// @param rows The amount of rows.
+        void setOverscan(int rows);
+
+        /// @brief Gets the amount of rows bound above and below the viewport.
+        [[nodiscard]] int getOverscan() const;
+
+        /// @brief Binds every visible view again, for when the items changed in place.
+        void refreshItems();
+
+        /// @brief Binds the view of an item again, if it has one.
+        /// @param index The index of the item.
+        void refreshItem(size_t index);
+
+        /// @brief Gets the view currently bound to an item.
+        /// @param index The index of the item.
+        /// @returns The view, nullptr if the item is out of the bound range.
+        [[nodiscard]] std::shared_ptr<GuiObject> getItemView(size_t index) const;
+
+        /// @brief Scrolls just enough for an item to be fully visible.
+        /// @param index The index of the item.
+        void scrollToItem(size_t index);
+
+        /// @brief Returns the class name of the object.
+        /// @return The class name.
+        inline std::string getClassName() const override { return "ListView"; }
+    };
+
+    /// @brief A ListView laying the items out in a grid, filling rows from left to right.
+    /// The amount of columns follows the width of the viewport.
+    class GridView : public ListView {
+    protected:
+        /// @brief The width of a cell, in pixels. The height is the item height.
+        int itemWidth = 64;
+
+        /// @brief The class name.
+        static inline const std::string CLASS_NAME = "GridView";
+
+        /// @brief As many cells as fit in the viewport, at least one.
+        [[nodiscard]] int columnCount(int viewportWidth) const override;
+
+        [[nodiscard]] SDL_Point cellSize(int viewportWidth) const override;
+
+    public:
+        GridView() = default;
+
+        class Builder final : public GuiObject::Builder<Builder, GridView> {};
+
+        /// @brief Sets the width of a cell.
+        /// @param width The width, in pixels.
+        void setItemWidth(int width);
+
+        /// @brief Gets the width of a cell, in pixels.
+        [[nodiscard]] int getItemWidth() const;
+
+        /// @brief Returns the class name of the object.
+        /// @return The class name.
+        inline std::string getClassName() const override { return "GridView"; }
+    };
+}
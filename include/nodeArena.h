@@ -0,0 +1,114 @@
+#pragma once
+
+#include "types.h"
+
+#include <memory_resource>
+
+namespace GUILib {
+
+    class ArenaScope;
+
+    namespace Reserved {
+
+        /// @brief Memory handed out in order from large chunks, for objects built together and dropped together.
+        /// Nothing is freed before the arena goes away, which frees every chunk at once.
+        /// Not thread safe, objects are built on the thread owning the renderer.
+        class NodeArena {
+        public:
+            /// @param chunkSize The size of the first chunk, the following ones grow from it.
+            explicit NodeArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+            NodeArena(const NodeArena&) = delete;
+            NodeArena& operator=(const NodeArena&) = delete;
+
+            /// @brief Hands out memory.
+            /// @param bytes The size.
+            /// @param alignment The alignment.
+            /// @returns The memory, never nullptr.
+            [[nodiscard]] void* allocate(size_t bytes, size_t alignment);
+
+            /// @brief Returns the amount of bytes handed out.
+            [[nodiscard]] size_t getBytes() const;
+
+            /// @brief Returns the arena of the innermost live ArenaScope on this thread, nullptr if there is none.
+            [[nodiscard]] static const std::shared_ptr<NodeArena>& current();
+
+            /// @brief The default size of the first chunk, in bytes.
+            static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        private:
+            friend class GUILib::ArenaScope;
+
+            std::pmr::monotonic_buffer_resource resource;
+            size_t bytes = 0;
+
+            /// @brief The arena objects are built in on this thread.
+            static inline thread_local std::shared_ptr<NodeArena> active;
+        };
+
+        /// @brief Allocates from a NodeArena, keeping it alive as long as something allocated from it is.
+        /// Deallocating does nothing, the memory comes back with the arena.
+        template <typename T>
+        class ArenaAllocator {
+        public:
+            using value_type = T;
+
+            explicit ArenaAllocator(std::shared_ptr<NodeArena> arena) noexcept : arena(std::move(arena)) {}
+
+            template <typename U>
+            ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+            [[nodiscard]] T* allocate(size_t n)
+            {
+                return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T*, size_t) noexcept {}
+
+            template <typename U>
+            bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+            template <typename U>
+            bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+
+        private:
+            template <typename U>
+            friend class ArenaAllocator;
+
+            std::shared_ptr<NodeArena> arena;
+        };
+
+        /// @brief Creates an object in the current arena, or on the heap when there is no ArenaScope alive.
+        /// The object and its control block share a single allocation either way.
+        template <typename T, typename... Args>
+        std::shared_ptr<T> makeNode(Args&&... args)
+        {
+            if (const auto& arena = NodeArena::current()) {
+                return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+            }
+            return std::make_shared<T>(std::forward<Args>(args)...);
+        }
+    }
+
+    /// @brief Makes the objects built on this thread, while the scope is alive, come from an arena.
+    /// Building a large tree then takes a few large allocations instead of one per object, and keeps the objects close in memory.
+    /// Scopes nest, the innermost one wins.
+    ///
+    /// Example:
+    /// {
+    ///     GUILib::ArenaScope scope(sceneManager.getArena());
+    ///     auto panel = GUILib::Frame::Builder().setRenderer(renderer).build(); // Comes from the arena of the scene
+    /// }
+    class ArenaScope {
+    public:
+        /// @param arena The arena. nullptr makes objects come from the heap again.
+        explicit ArenaScope(std::shared_ptr<Reserved::NodeArena> arena);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        /// @brief The arena of the enclosing scope, brought back on destruction.
+        std::shared_ptr<Reserved::NodeArena> previous;
+    };
+}
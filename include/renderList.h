@@ -0,0 +1,173 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief A renderer-scoped list of draw commands: fills, textured quads, lines and clip changes.
+        /// While recording, commands are turned into vertices, and consecutive ones sharing a texture and a clip rect
+        /// are merged into a single SDL_RenderGeometry() call when the list is submitted.
+        /// The list is kept after submitting, so an unchanged scene can be drawn again without walking it.
+        /// Outside of a recording, commands are drawn right away.
+        class RenderList {
+        public:
+            /// @brief Counters describing how the list has been used.
+            struct Stats {
+                /// @brief Commands recorded.
+                size_t commands = 0;
+                /// @brief Recorded commands that joined the run of the previous one, instead of starting a draw call of their own.
+                size_t merged = 0;
+                /// @brief Draw calls made by submit().
+                size_t drawCalls = 0;
+                /// @brief Draw calls made by submit() with another texture than the call before, plain quads counting as a texture.
+                size_t textureSwitches = 0;
+                /// @brief Commands drawn right away, outside of a recording.
+                size_t immediateDraws = 0;
+                /// @brief Submissions of a recording that had been submitted already.
+                size_t replays = 0;
+            };
+
+            /// @brief Returns the list associated with the renderer, creating it if needed.
+            /// @param r The renderer.
+            /// @returns The list.
+            static RenderList& get(SDL_Renderer* r);
+
+            /// @brief Drops the list of the renderer.
+            /// Must be called before destroying the renderer, or when its targets are reset, as the list points to textures.
+            /// @param r The renderer.
+            static void releaseRenderer(SDL_Renderer* r);
+
+            /// @brief Drops the recorded commands and starts recording new ones.
+            void begin();
+
+            /// @brief Stops recording. The recorded commands are kept until the next begin() or clear().
+            void end();
+
+            /// @brief Returns whether commands are being recorded.
+            [[nodiscard]] bool isRecording() const;
+
+            /// @brief Draws the recorded commands.
+            /// @param area Only draws within this rect, skipping the quads outside of it. Draws everything when nullptr.
+            void submit(const SDL_Rect* area = nullptr);
+
+            /// @brief Drops the recorded commands.
+            void clear();
+
+            /// @brief Sets the recorded commands aside and starts an empty recording, for drawing into another target.
+            /// The commands recorded until popLayer() can be submitted on their own.
+            void pushLayer();
+
+            /// @brief Drops the recorded commands and brings back the ones set aside by the last pushLayer().
+            void popLayer();
+
+            /// @brief Moves the recorded commands and clip rects.
+            /// @param dx The horizontal offset, in pixels.
+            /// @param dy The vertical offset, in pixels.
+            void translate(int dx, int dy);
+
+            /// @brief Returns the amount of draw calls submit() makes.
+            [[nodiscard]] size_t runCount() const;
+
+            /// @brief Draws a solid box, blended.
+            /// @param color The color of the box.
+            /// @param rect The destination rect.
+            /// @param angle The clockwise rotation, in degrees.
+            /// @param pivot The rotation center, relative to the rect. Uses the center when nullptr.
+            void fill(const SDL_Color& color, const SDL_Rect& rect, double angle = 0.0, const SDL_Point* pivot = nullptr);
+
+            /// @brief Draws an area of a texture, like SDL_RenderCopyEx().
+            /// The texture must outlive the recording.
+            /// @param texture The texture.
+            /// @param source The area of the texture to draw.
+            /// @param dest The destination rect.
+            /// @param angle The clockwise rotation, in degrees.
+            /// @param pivot The rotation center, relative to the rect. Uses the center when nullptr.
+            /// @param flip The flipping to apply.
+            void copy(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest, double angle = 0.0, const SDL_Point* pivot = nullptr, SDL_RendererFlip flip = SDL_FLIP_NONE);
+
+            /// @brief Draws textured quads.
+            /// The texture must outlive the recording.
+            /// @param texture The texture, nullptr for plain colored quads.
+            /// @param quads The vertices, four per quad (top left, top right, bottom right, bottom left).
+            void quads(SDL_Texture* texture, const std::vector<SDL_Vertex>& quads);
+
+            /// @brief Draws a one pixel wide line, ends included.
+            /// @param color The color of the line.
+            void line(const SDL_Color& color, int x1, int y1, int x2, int y2);
+
+            /// @brief Clips the following commands to a rect, within the current clip rect.
+            /// @param rect The rect.
+            void pushClip(const SDL_Rect& rect);
+
+            /// @brief Restores the clip rect in use before the last pushClip().
+            void popClip();
+
+            /// @brief Returns the counters of this list.
+            [[nodiscard]] const Stats& getStats() const;
+
+            /// @brief Resets the counters of this list.
+            void resetStats();
+
+            explicit RenderList(SDL_Renderer* r);
+
+            RenderList(const RenderList&) = delete;
+            RenderList& operator=(const RenderList&) = delete;
+
+        private:
+            /// @brief Consecutive vertices drawn with one call.
+            struct Run {
+                SDL_Texture* texture;
+                /// @brief The clip rect, unused when clipped is false.
+                SDL_Rect clip;
+                bool clipped;
+                size_t first, count;
+            };
+
+            /// @brief A recording set aside by pushLayer().
+            struct Layer {
+                std::vector<SDL_Vertex> vertices;
+                std::vector<Run> runs;
+                std::vector<SDL_Rect> clips;
+                bool recording;
+                bool submitted;
+            };
+
+            SDL_Renderer* renderer;
+            bool recording = false;
+            /// @brief Whether the recorded commands were submitted at least once.
+            bool submitted = false;
+
+            std::vector<SDL_Vertex> vertices;
+            std::vector<Run> runs;
+            /// @brief Reused storage for the quads of a run within the submitted area.
+            std::vector<SDL_Vertex> culled;
+            /// @brief The recordings set aside, the last one pushed at the back.
+            std::vector<Layer> layers;
+            /// @brief The clip rects pushed, each one already within the previous.
+            std::vector<SDL_Rect> clips;
+
+            Stats stats;
+
+            /// @brief Whether the current clip rect hides everything.
+            [[nodiscard]] bool isClippedOut() const;
+            /// @brief Records quads, continuing the last run when possible, or draws them right away when not recording.
+            void emit(SDL_Texture* texture, const SDL_Vertex* quadVertices, size_t count);
+            /// @brief Applies the current clip rect to the renderer.
+            void applyClip() const;
+            /// @brief Draws the quads of a run, counting the draw call.
+            void drawRun(SDL_Texture* texture, const SDL_Vertex* runVertices, size_t count, SDL_Texture*& previousTexture, bool& first);
+            /// @brief Emits a quad turned around a pivot.
+            void emitQuad(SDL_Texture* texture, const SDL_Rect& dest, double angle, const SDL_Point* pivot, const SDL_Color& color, SDL_FPoint uv0, SDL_FPoint uv1);
+        };
+
+        /// @brief Draws a solid box through the render list of the renderer.
+        /// @param r The renderer.
+        /// @param color The color of the box.
+        /// @param rect The destination rect.
+        /// @param angle The clockwise rotation, in degrees.
+        /// @param pivot The rotation center, relative to the rect. Uses the center when nullptr.
+        void renderSolidBox(SDL_Renderer* r, const SDL_Color& color, const SDL_Rect& rect, double angle = 0.0, const SDL_Point* pivot = nullptr);
+    }
+}
@@ -78,7 +78,7 @@ namespace GUILib {
 
         /// @brief Handles all events.
         /// @param event The event.
-        void handleEvent(const SDL_Event& event) override;
+        void processEvent(const SDL_Event& event) override;
 
         /// @brief Returns the class name of the object.
 		/// @return The class name.
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    class GuiObject;
+
+    namespace Reserved {
+
+        /// @brief A uniform grid over the rects of the visible and active objects of a scene.
+        /// @brief Resolves the topmost object under a point without visiting the whole tree.
+        /// Objects moved by the layout pass only have their cells updated, other changes of the indexed trees make it rebuilt.
+        class SpatialIndex {
+        public:
+            /// @brief Creates an empty index.
+            /// @param cellSize The size of a grid cell, in pixels.
+            explicit SpatialIndex(int cellSize = 64);
+            SpatialIndex(const SpatialIndex& other);
+            SpatialIndex& operator=(const SpatialIndex& other) = default;
+            ~SpatialIndex();
+
+            /// @brief Rebuilds the index from the passed object trees.
+            /// Objects are ordered the same way they are rendered, later ones being on top.
+            /// @param roots The root objects, in rendering order.
+            /// @param area The size of the indexed area, usually the renderer output size.
+            void rebuild(const std::vector<std::shared_ptr<GuiObject>>& roots, const SDL_Point& area);
+
+            /// @brief Moves the objects laid out since the last call to the cells of their new rect.
+            void update();
+
+            /// @brief Returns whether the index has to be rebuilt, the indexed trees having changed otherwise than by moving objects.
+            /// @returns Whether it's out of date.
+            [[nodiscard]] bool isStale() const;
+
+            /// @brief Returns the size of the indexed area.
+            /// @returns The size passed to the last rebuild.
+            [[nodiscard]] SDL_Point getArea() const;
+
+            /// @brief Finds the topmost object under the point.
+            /// @param point The point.
+            /// @returns The object, or nullptr if there is none.
+            [[nodiscard]] GuiObject* query(const SDL_Point& point) const;
+
+            /// @brief Returns the amount of indexed objects.
+            /// @returns The amount.
+            [[nodiscard]] size_t size() const;
+
+            /// @brief Empties the index, it's stale until rebuilt.
+            void clear();
+
+            /// @brief Lets the indexes holding the object know that it was laid out somewhere else.
+            /// @param object The object.
+            /// @param rect Its new rect.
+            static void objectMoved(const GuiObject* object, const SDL_Rect& rect);
+
+            /// @brief Makes the indexes holding the object or its parent stale.
+            /// For changes of visibility, activity, parent, or of which children are in view.
+            /// @param object The object.
+            static void objectChanged(const GuiObject* object);
+
+        private:
+            /// @brief An indexed object, its position in the entries is its rendering order.
+            struct Entry {
+                GuiObject* object;
+                /// @brief The rect of the object.
+                SDL_Rect bounds;
+                /// @brief The intersection of the rects of the ancestors that clip it.
+                SDL_Rect clip;
+                /// @brief The rect of the object, clipped by its ancestors. Empty for objects not receiving events.
+                SDL_Rect rect;
+                /// @brief Whether its children were visited, all the ones in view being indexed.
+                bool childrenIndexed;
+                /// @brief Whether it's listed in moved.
+                bool moved;
+            };
+
+            int cellSize;
+            int columns = 0, rows = 0;
+            SDL_Point area {};
+            bool stale = true;
+
+            std::vector<Entry> entries;
+            /// @brief The entry of each visited object, the ones not receiving events included.
+            std::unordered_map<const GuiObject*, uint32_t> entryOf;
+            /// @brief The entries of each cell, in rendering order.
+            std::vector<std::vector<uint32_t>> cells;
+            /// @brief The entries moved since the last update().
+            std::vector<uint32_t> moved;
+
+            /// @brief The indexes alive, which objects report to.
+            static inline std::vector<SpatialIndex*> instances;
+
+            /// @brief Collects the entries of a subtree.
+            void collect(GuiObject* object, const SDL_Rect& clip);
+
+            /// @brief Adds the entry to the cells covered by its rect, or removes it from them.
+            void place(uint32_t entry, bool add);
+
+            /// @brief Returns the entry of the object.
+            /// @returns A pointer to its index, or nullptr if it isn't indexed.
+            [[nodiscard]] const uint32_t* find(const GuiObject* object) const;
+
+            /// @brief Returns the range of cells covered by the rect.
+            /// @returns Whether the rect covers any cell.
+            bool cellRange(const SDL_Rect& rect, int& x0, int& y0, int& x1, int& y1) const;
+        };
+    }
+}
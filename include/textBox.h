@@ -5,6 +5,8 @@
 
 #include "types.h"
 #include "guiobject.h"
+#include "textWrap.h"
+#include "textBuffer.h"
 
 
 namespace GUILib {
@@ -22,13 +24,13 @@ namespace GUILib {
 
         std::pair<int, int> textRenderLocation;
 
-        /// @brief The split lines for rendering.
-        std::vector<std::string> lines;
+        /// @brief Wraps the text into the lines for rendering, only rewrapping the paragraphs that changed.
+        Reserved::TextWrapper wrapper;
 
         /// @brief The height of the lines based on the size of it.
         [[nodiscard]] int lineHeight() const;
 
-        /// @brief Splits the text into lines.
+        /// @brief Splits the text into lines, from scratch.
         [[nodiscard]] std::vector<std::string> splitTextIntoLines(const std::string& str, const int& maxWidth) const;
 
         /// @brief Renders the text box.
@@ -39,16 +41,70 @@ namespace GUILib {
         SDL_Color textColor;
 
         /// @brief A struct that stores information about a rendered line in the text box.
+        /// The text of the line is the line of the wrapper with the same index.
         struct RenderedLine {
-            /// @brief The text on that line.
-            std::string text; 
-            /// @brief Pixel position on screen (x, y)
+            /// @brief The width of the line, in pixels.
+            int width;
+            /// @brief Pixel position (x, y), relative to the top left of the box.
             SDL_Point position; 
         };
 
         /// @brief The lines that will be rendered.
         std::vector<RenderedLine> renderedLines;
 
+        /// @brief Wraps the text into the lines of the wrapper.
+        /// @param maxWidth The width lines are wrapped at, in pixels.
+        virtual void wrapText(int maxWidth);
+
+        /// @brief Returns the length of the text, in bytes.
+        [[nodiscard]] virtual size_t textLength() const;
+
+        bool getTweenValue(TweenType type, double* values) const override;
+        void setTweenValue(TweenType type, const double* values) override;
+
+        /// @brief Bumped on every change of the text.
+        std::uint64_t textRevision = 0;
+
+        /// @brief Marks the laid out lines as out of date.
+        /// Must be called after modifying text directly.
+        void invalidateText();
+
+        /// @brief What the laid out lines depend on.
+        struct TextLayoutKey {
+            std::uint64_t textRevision;
+            TTF_Font* font;
+            int width, height;
+            HorizontalTextAlign xAlign;
+            VerticalTextAlign yAlign;
+
+            bool operator==(const TextLayoutKey& other) const;
+        };
+
+        /// @brief What the glyph quads depend on, besides the layout.
+        struct GlyphQuadKey {
+            std::uint64_t atlasId;
+            int x, y;
+            Uint32 color;
+            /// @brief The visible area of the renderer, lines outside of it have no quads.
+            SDL_Rect view;
+
+            bool operator==(const GlyphQuadKey& other) const;
+            bool operator!=(const GlyphQuadKey& other) const;
+        };
+
+        /// @brief The key lines and renderedLines were laid out with. Empty if they are out of date.
+        std::optional<TextLayoutKey> textLayoutKey;
+        /// @brief The key glyphQuads were built with. Empty if they are out of date.
+        std::optional<GlyphQuadKey> glyphQuadKey;
+        /// @brief The quads of the laid out text, per page of the glyph atlas.
+        std::vector<std::vector<SDL_Vertex>> glyphQuads;
+
+        /// @brief Lays the text out again, if the text, font, size or alignment changed since the last time.
+        void refreshTextLayout();
+
+        /// @brief Draws the laid out lines from the glyph atlas of the font.
+        void renderText();
+
 		TextBox(
             std::shared_ptr<GuiObject> parent,
             SDL_Renderer* renderer,
@@ -92,7 +148,7 @@ namespace GUILib {
 
         /// @brief Returns the text of the text box.
         /// @return The text of the text box.
-        [[nodiscard]] std::string getText() const;
+        [[nodiscard]] virtual std::string getText() const;
 
         /// @brief Changes the background color.
         void setBoxColor(const SDL_Color& color);
@@ -101,7 +157,7 @@ namespace GUILib {
         void setTextColor(const SDL_Color& color);
 
         /// @brief Changes the text of the text box.
-        void setText(const std::string& str);
+        virtual void setText(const std::string& str);
 
         /// @brief Changes the font of the text.
         void changeFont(TTF_Font*& font);
@@ -124,6 +180,33 @@ namespace GUILib {
         /// @brief The cursor position.
         size_t cursorPosition;
 
+        /// @brief The content of the box. TextBox::text is left empty.
+        Reserved::TextBuffer buffer;
+
+        /// @brief Whether every paragraph must be wrapped again, instead of only the edited ones.
+        bool wrapAll = true;
+        /// @brief Whether some paragraphs were edited since the last wrap.
+        bool hasPendingEdit = false;
+        /// @brief The edited paragraphs, [pendingFirst, pendingEnd) in the current text.
+        size_t pendingFirst = 0, pendingEnd = 0;
+        /// @brief How many paragraphs the edits added (or removed, when negative).
+        std::ptrdiff_t pendingDelta = 0;
+
+        /// @brief Inserts text in the buffer, and records the edit for the next wrap.
+        void insertText(size_t position, std::string_view str);
+        /// @brief Erases text from the buffer, and records the edit for the next wrap.
+        void eraseText(size_t position, size_t count);
+        /// @brief Records that paragraphs [paragraph, paragraph + removed] became [paragraph, paragraph + inserted].
+        void markEdited(size_t paragraph, size_t removed, size_t inserted);
+
+        /// @brief Maps a position in the text to a wrapped line and a column in it.
+        [[nodiscard]] std::pair<size_t, size_t> cursorToLine(size_t position) const;
+        /// @brief Maps a wrapped line and a column in it to a position in the text.
+        [[nodiscard]] size_t lineToCursor(size_t line, size_t column) const;
+
+        void wrapText(int maxWidth) override;
+        [[nodiscard]] size_t textLength() const override;
+
         /// @brief Handles the backspace key.
         void handleBackspace();
         /// @brief Handles the left arrow key.
@@ -139,6 +222,16 @@ namespace GUILib {
 
         /// @brief Inserts a character.
         void insertCharacter(char c);
+        /// @brief Inserts typed UTF-8 text at the cursor, indenting like insertCharacter() does.
+        void insertInput(std::string_view input);
+
+        /// @brief Shows the cursor right away when the box gets the focus, and hides it when the box loses it.
+        void focusChanged(bool hasFocus) override;
+
+        /// @brief Returns where the UTF-8 character before a position starts.
+        [[nodiscard]] size_t previousCharacter(size_t position) const;
+        /// @brief Returns where the UTF-8 character after the one at a position starts.
+        [[nodiscard]] size_t nextCharacter(size_t position) const;
 
         /// @brief The key actions for special keys.
         std::unordered_map<SDL_Keycode, std::function<void()>> keyActions;
@@ -147,6 +240,9 @@ namespace GUILib {
         bool editable;
 
 
+        /// @brief Whether the box has the keyboard focus, the cursor is only drawn then.
+        bool focused = false;
+
         /// Blinking timer and visibility
         bool cursorVisible = true;
         std::chrono::time_point<std::chrono::steady_clock> lastBlinkTime;
@@ -167,6 +263,8 @@ namespace GUILib {
         /// @brief Whether the automatic indentation be enabled.
         bool shouldIndent;
 
+        Reserved::SignalBase* findSignal(std::string_view eventName) override;
+
         EditableTextBox(
             std::shared_ptr<GuiObject> parent,
             SDL_Renderer*& renderer,
@@ -180,6 +278,16 @@ namespace GUILib {
             bool editable = false
         );
     public:
+        /// @brief Fired after a special key (backspace, arrows...) has been handled.
+        Signal<> onSpecialKeyInput;
+        /// @brief Fired after a character has been inserted, with the character.
+        /// With multibyte or composed input, only the first byte is given; use onTextInput for the whole text.
+        Signal<char> onKeyInput;
+        /// @brief Fired after text has been typed in, with the UTF-8 text. Usually one character, more with input methods.
+        Signal<std::string> onTextInput;
+        /// @brief Fired by setEditable().
+        Signal<> onEditableChange;
+
         EditableTextBox();
 
         /// @brief Gets whether the box should indent automatically.
@@ -209,9 +317,28 @@ namespace GUILib {
         /// @brief Resets the text box.
         void reset();
 
+        /// @brief Returns the text of the text box.
+        /// @return A copy of the text.
+        [[nodiscard]] std::string getText() const override;
+
+        /// @brief Replaces the text of the text box.
+        void setText(const std::string& str) override;
+
         /// @brief Handles the events.
         /// @param e The event to be handled.
-        void handleEvent(const SDL_Event& e) override;
+        void processEvent(const SDL_Event& e) override;
+
+        /// @brief Editable text boxes take the keyboard focus.
+        /// @returns Always true.
+        [[nodiscard]] bool isFocusable() const override;
+
+        /// @brief Editable text boxes take text input.
+        /// @returns Whether the box is editable.
+        [[nodiscard]] bool acceptsTextInput() const override;
+
+        /// @brief Editable text boxes indent with the Tab key, when they have an indentation size.
+        /// @returns Whether the box uses the key.
+        [[nodiscard]] bool handlesTab() const override;
 
         /// @brief Renders the text box.
         void render() override;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief A gap buffer for editable text, with an index of the line starts.
+        /// Edits near the previous one only move a few bytes, and position to line lookups are O(log n).
+        /// Lines are separated by '\n', the separator belongs to the line before it.
+        class TextBuffer {
+        public:
+            TextBuffer();
+
+            /// @brief Returns the length of the text, in bytes.
+            [[nodiscard]] size_t size() const;
+
+            /// @brief Returns whether the text is empty.
+            [[nodiscard]] bool empty() const;
+
+            /// @brief Returns the byte at the position.
+            [[nodiscard]] char operator[](size_t position) const;
+
+            /// @brief Inserts text.
+            /// @param position Where to insert, clamped to the size.
+            /// @param str The text.
+            void insert(size_t position, std::string_view str);
+
+            /// @brief Erases text.
+            /// @param position Where to erase from.
+            /// @param count How many bytes to erase, clamped to the end.
+            void erase(size_t position, size_t count);
+
+            /// @brief Replaces the whole text.
+            void assign(std::string_view str);
+
+            /// @brief Empties the buffer.
+            void clear();
+
+            /// @brief Copies a part of the text.
+            /// @param position Where to start.
+            /// @param count How many bytes, clamped to the end.
+            [[nodiscard]] std::string substr(size_t position, size_t count) const;
+
+            /// @brief Copies the whole text.
+            [[nodiscard]] std::string toString() const;
+
+            /// @brief Returns the amount of lines, which is one more than the amount of '\n'.
+            [[nodiscard]] size_t lineCount() const;
+
+            /// @brief Returns the line the position is on.
+            [[nodiscard]] size_t lineOf(size_t position) const;
+
+            /// @brief Returns the position of the first byte of a line.
+            [[nodiscard]] size_t lineStart(size_t line) const;
+
+            /// @brief Returns the position right after the last byte of a line, its '\n' excluded.
+            [[nodiscard]] size_t lineEnd(size_t line) const;
+
+            /// @brief Copies a line, without its '\n'.
+            [[nodiscard]] std::string line(size_t line) const;
+
+        private:
+            /// @brief The text, with the gap in [gapStart, gapEnd).
+            std::vector<char> data;
+            size_t gapStart, gapEnd;
+
+            /// @brief The positions of every '\n', in order.
+            /// Entries from shiftFrom on are stored without pendingShift, so edits don't have to update every later line.
+            std::vector<size_t> newlines;
+            size_t shiftFrom;
+            std::ptrdiff_t pendingShift;
+
+            [[nodiscard]] size_t gapLength() const;
+            /// @brief Moves the gap to the position.
+            void moveGap(size_t position);
+            /// @brief Makes the gap at least length bytes long.
+            void reserveGap(size_t length);
+
+            /// @brief Returns the position of the n-th '\n'.
+            [[nodiscard]] size_t newlineAt(size_t index) const;
+            /// @brief Moves the start of the lazily shifted entries to the index.
+            void moveShiftBoundary(size_t index);
+        };
+    }
+}
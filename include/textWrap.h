@@ -0,0 +1,105 @@
+#pragma once
+
+#include "types.h"
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        class FontMetrics;
+
+        /// @brief Word-wraps text, measuring it with cached glyph advances and kerning.
+        /// Keeps the wrapped lines of every paragraph, so an edit only rewraps the paragraphs it touched.
+        /// The lines concatenated, with a '\n' between paragraphs, give back the text.
+        class TextWrapper {
+        public:
+            /// @brief Wraps the text, reusing the lines of the paragraphs that didn't change since the last call.
+            /// @param text The UTF-8 text.
+            /// @param font The font to measure with.
+            /// @param maxWidth The width lines are wrapped at, in pixels.
+            void update(std::string_view text, TTF_Font* font, int maxWidth);
+
+            /// @brief Returns whether the lines were wrapped with this font and width.
+            [[nodiscard]] bool matches(TTF_Font* font, int maxWidth) const;
+
+            /// @brief Wraps every paragraph from scratch.
+            /// For owners that track their edits themselves, see replaceParagraphs().
+            /// @param paragraphs The UTF-8 paragraphs, without '\n'.
+            /// @param font The font to measure with.
+            /// @param maxWidth The width lines are wrapped at, in pixels.
+            void assignParagraphs(const std::vector<std::string>& paragraphs, TTF_Font* font, int maxWidth);
+
+            /// @brief Replaces some paragraphs, only wrapping the new ones. The font and width must match().
+            /// @param first The index of the first replaced paragraph.
+            /// @param count The amount of replaced paragraphs.
+            /// @param paragraphs The new paragraphs, without '\n'.
+            void replaceParagraphs(size_t first, size_t count, const std::vector<std::string>& paragraphs);
+
+            /// @brief Returns the wrapped lines.
+            [[nodiscard]] const std::vector<std::string>& getLines() const;
+
+            /// @brief Returns the width of each wrapped line, trailing spaces included.
+            [[nodiscard]] const std::vector<int>& getWidths() const;
+
+            /// @brief Returns the amount of paragraphs.
+            [[nodiscard]] size_t paragraphCount() const;
+
+            /// @brief Returns the index of the first line of a paragraph.
+            [[nodiscard]] size_t paragraphFirstLine(size_t paragraph) const;
+
+            /// @brief Returns the amount of lines a paragraph was wrapped into. Always at least one.
+            [[nodiscard]] size_t paragraphLineCount(size_t paragraph) const;
+
+            /// @brief Returns the paragraph a line belongs to.
+            [[nodiscard]] size_t paragraphOfLine(size_t line) const;
+
+            /// @brief Forgets everything, the next update wraps the whole text.
+            void clear();
+
+            /// @brief Wraps a single paragraph. Words are only broken at spaces, a word wider than maxWidth gets its own line.
+            /// @param paragraph The UTF-8 paragraph, without '\n'.
+            /// @param metrics The metrics to measure with.
+            /// @param maxWidth The width lines are wrapped at, in pixels.
+            /// @param lines The lines are appended here.
+            /// @param widths The width of the lines are appended here.
+            static void wrapParagraph(
+                std::string_view paragraph,
+                FontMetrics& metrics,
+                int maxWidth,
+                std::vector<std::string>& lines,
+                std::vector<int>& widths
+            );
+
+        private:
+            struct Paragraph {
+                /// @brief The byte offset of the paragraph in the text.
+                size_t start;
+                /// @brief The index of its first line.
+                size_t firstLine;
+                size_t lineCount;
+            };
+
+            /// @brief The text the lines were wrapped from, only kept for update().
+            std::string source;
+            /// @brief Whether source holds the text, it doesn't after replaceParagraphs().
+            bool hasSource = false;
+            /// @brief The length of the text plus one, counting a '\n' after every paragraph.
+            size_t coveredBytes = 0;
+
+            TTF_Font* font = nullptr;
+            int maxWidth = 0;
+            /// @brief Whether font and maxWidth describe the lines.
+            bool valid = false;
+
+            std::vector<Paragraph> paragraphs;
+            std::vector<std::string> lines;
+            std::vector<int> widths;
+
+            /// @brief Replaces count paragraphs from first by the new ones, and shifts the ones after.
+            void splice(size_t first, size_t count, const std::vector<std::string_view>& newParagraphs);
+
+            /// @brief Returns the index of the paragraph containing the byte offset.
+            [[nodiscard]] size_t paragraphAt(size_t offset) const;
+        };
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "types.h"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief A texture shared between the objects showing it. Destroyed with its last owner.
+        using SharedTexture = std::shared_ptr<SDL_Texture>;
+
+        /// @brief The area of a texture holding an image. Small images share atlas pages.
+        struct TextureRegion {
+            SharedTexture texture;
+            /// @brief The area of the image in the texture.
+            SDL_Rect source {};
+
+            explicit operator bool() const { return texture != nullptr; }
+        };
+
+        /// @brief A renderer-scoped cache for textures loaded from image files, keyed by path.
+        /// Objects showing the same file share one texture, small files are packed in the ImageAtlas. Textures nobody uses anymore are kept
+        /// until the byte budget is exceeded, then dropped least recently used first.
+        class TextureCache {
+        public:
+            /// @brief Counters describing how the cache has been used.
+            struct Stats {
+                /// @brief Loads served from the cache.
+                size_t hits = 0;
+                /// @brief Loads that had to decode the file.
+                size_t misses = 0;
+                /// @brief Unused textures dropped to respect the byte budget.
+                size_t evictions = 0;
+            };
+
+            /// @brief Returns the cache associated with the renderer, creating it if needed.
+            /// @param r The renderer.
+            /// @returns The cache.
+            static TextureCache& get(SDL_Renderer* r);
+
+            /// @brief Forgets every texture cached for the renderer. Textures still in use live on with their owners.
+            /// Must be called before destroying the renderer, or when its device is reset.
+            /// @param r The renderer.
+            static void releaseRenderer(SDL_Renderer* r);
+
+            /// @brief Returns the texture of an image file, decoding it on first use.
+            /// @param path The path of the file.
+            /// @returns The texture, empty if the file couldn't be loaded. See SDL_GetError().
+            [[nodiscard]] TextureRegion load(const std::string& path);
+
+            /// @brief A function called on the render thread once the file it waits on is uploaded, or failed to be.
+            using Waiter = std::function<void()>;
+
+            /// @brief Returns the texture of an image file, decoding it on a worker thread on first use.
+            /// Only the upload happens on the calling thread, which must be the render thread.
+            /// @param path The path of the file.
+            /// @param waiter Called once the file is done decoding, if it still is. Dropped uncalled with the cache.
+            /// @returns The texture, empty if the file couldn't be loaded (see SDL_GetError()),
+            /// std::nullopt while the file is still being decoded.
+            [[nodiscard]] std::optional<TextureRegion> loadAsync(const std::string& path, std::shared_ptr<Waiter> waiter = nullptr);
+
+            /// @brief Uploads the files decoded since the last call and calls their waiters. Done by loadAsync() as well.
+            /// The workers push an event when they are done, so a loop waiting for events gets to call it.
+            void uploadDecoded();
+
+            /// @brief Forgets every cached texture and failed file. Counters are kept.
+            void clear();
+
+            /// @brief Sets the amount of texture memory the cache may hold, in bytes.
+            /// Textures in use are never dropped, so the cache can go over it.
+            /// @param value The new budget.
+            void setByteBudget(size_t value);
+
+            /// @brief Returns the amount of texture memory the cache may hold, in bytes.
+            [[nodiscard]] size_t getByteBudget() const;
+
+            /// @brief Returns the approximate memory used by the cached textures, in bytes.
+            [[nodiscard]] size_t getBytes() const;
+
+            /// @brief Returns the amount of cached textures.
+            [[nodiscard]] size_t size() const;
+
+            /// @brief Returns the counters of this cache.
+            [[nodiscard]] const Stats& getStats() const;
+
+            /// @brief Resets the counters of this cache.
+            void resetStats();
+
+            explicit TextureCache(SDL_Renderer* r);
+
+            TextureCache(const TextureCache&) = delete;
+            TextureCache& operator=(const TextureCache&) = delete;
+
+            ~TextureCache();
+
+        private:
+            struct Entry {
+                std::string path;
+                TextureRegion region;
+                /// @brief The memory of the texture, 0 for images packed in an atlas page.
+                size_t bytes;
+                /// @brief False until an uploaded texture has been handed out, so it isn't dropped before anyone got it.
+                bool claimed;
+            };
+
+            /// @brief A file decoded by a worker, surface is nullptr with the error if it failed.
+            struct Decoded {
+                std::string path;
+                SDL_Surface* surface;
+                std::string error;
+            };
+
+            /// @brief Where the workers leave decoded files.
+            /// Shared with the jobs, so they can finish after the cache is released.
+            struct Inbox {
+                std::mutex mutex;
+                std::vector<Decoded> decoded;
+
+                ~Inbox();
+            };
+
+            /// @brief The renderer the textures belong to.
+            SDL_Renderer* renderer;
+            /// @brief Most recently used entries are at the front.
+            std::list<Entry> entries;
+            /// @brief Lookup table into the entries.
+            std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+
+            std::shared_ptr<Inbox> inbox = std::make_shared<Inbox>();
+            /// @brief The files handed to the workers and not uploaded yet.
+            std::unordered_set<std::string> decoding;
+            /// @brief The functions waiting on each file being decoded.
+            std::unordered_map<std::string, std::vector<std::shared_ptr<Waiter>>> waiters;
+            /// @brief The files that couldn't be decoded, with the error.
+            std::unordered_map<std::string, std::string> failed;
+
+            size_t byteBudget = 64 * 1024 * 1024;
+            size_t bytes = 0;
+            Stats stats;
+
+            /// @brief Uploads a decoded surface and caches the texture. Frees the surface.
+            TextureRegion insert(const std::string& path, SDL_Surface* surface, bool claimed);
+            /// @brief Drops least recently used textures nobody else owns, until the budget is respected.
+            void trim();
+        };
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "TweenService.h"
+#include "easing.h"
+
+namespace GUILib {
+
+    /// @brief Identifies a tween started by a TweenScheduler. Stops matching once the tween ends, even if its slot is reused.
+    struct TweenHandle {
+        std::uint32_t slot = UINT32_MAX;
+        std::uint32_t generation = 0;
+    };
+
+    /// @brief Runs many tweens at once, advancing all of them in one pass per frame.
+    /// Tweens are kept in arrays, one per field, and interpolated an array at a time.
+    /// The size and position are written into the layout store and only mark the layout out of date, it's resolved when the scene is rendered.
+    /// onPositionChange and onSizeChange are still fired at every step.
+    /// Finished slots are reused by the next tweens started. Not thread safe, like the objects.
+    class TweenScheduler {
+    public:
+        /// @brief Starts tweening the size, position or pivot offset of an object from its current value,
+        /// replacing the tween already running on it.
+        /// @param obj The object.
+        /// @param type TweenType::SIZE, TweenType::POSITION or TweenType::PIVOT.
+        /// @param to The value reached at the end. Must use scale if the current value does, and the other way around.
+        /// @param duration The duration, in seconds.
+        /// @param curve The easing curve.
+        /// @returns The handle of the tween, matching no tween if it couldn't be started.
+        TweenHandle start(const std::shared_ptr<GuiObject>& obj, TweenType type, const UIUnit& to, double duration,
+            EasingCurve curve = EasingCurve::LINEAR);
+
+        /// @brief Starts tweening the rotation or the alpha of an object, see start().
+        /// @param type TweenType::ROTATION, in degrees, or TweenType::ALPHA, from 0 to 255.
+        TweenHandle start(const std::shared_ptr<GuiObject>& obj, TweenType type, double to, double duration,
+            EasingCurve curve = EasingCurve::LINEAR);
+
+        /// @brief Starts tweening a color of an object, see start().
+        /// @param type TweenType::COLOR or TweenType::TEXT_COLOR.
+        TweenHandle startColor(const std::shared_ptr<GuiObject>& obj, TweenType type, const SDL_Color& to, double duration,
+            EasingCurve curve = EasingCurve::LINEAR);
+
+        /// @brief Starts tweening the scroll position of a scrolling frame, see start().
+        /// @param to The scroll position reached at the end, in pixels.
+        TweenHandle startScroll(const std::shared_ptr<GuiObject>& obj, const SDL_Point& to, double duration,
+            EasingCurve curve = EasingCurve::LINEAR);
+
+        /// @brief Stops a tween, leaving the property where it is.
+        /// @returns Whether the tween was running.
+        bool cancel(const TweenHandle& handle);
+
+        /// @brief Returns whether a tween is running.
+        [[nodiscard]] bool isActive(const TweenHandle& handle) const;
+
+        /// @brief Advances every tween. Tweens of objects that are gone are dropped.
+        /// @param deltaTime The time since the last call, in seconds.
+        void update(double deltaTime);
+
+        /// @brief Stops every tween.
+        void clear();
+
+        /// @brief Returns the amount of tweens running.
+        [[nodiscard]] size_t size() const;
+
+    private:
+        static constexpr std::uint32_t NO_INDEX = UINT32_MAX;
+        /// @brief The most values a property has, the 4 channels of a color.
+        static constexpr size_t COMPONENTS = 4;
+
+        // The running tweens, packed at the front of every array
+        std::vector<double> progress, rates, eased;
+        std::vector<EasingCurve> curves;
+        std::vector<double> starts[COMPONENTS], deltas[COMPONENTS], values[COMPONENTS];
+        std::vector<Reserved::NodeHandle> nodes;
+        std::vector<TweenType> types;
+        std::vector<std::uint8_t> scaled;
+        std::vector<GuiObject*> owners;
+        /// @brief Tells whether the owners are still alive, checked before writing to them.
+        std::vector<std::weak_ptr<GuiObject>> lifetimes;
+        /// @brief The slot of each tween.
+        std::vector<std::uint32_t> slots;
+
+        /// @brief The index of the tween in the arrays, by slot, NO_INDEX for a free slot.
+        std::vector<std::uint32_t> indices;
+        /// @brief Bumped every time a slot is freed, by slot.
+        std::vector<std::uint32_t> generations;
+        /// @brief Slots freed and not reused yet.
+        std::vector<std::uint32_t> freeSlots;
+        /// @brief The slot of the tween running on a property, keyed by node and type.
+        std::unordered_map<std::uint64_t, std::uint32_t> running;
+
+        [[nodiscard]] static std::uint64_t key(Reserved::NodeHandle node, TweenType type);
+
+        /// @brief Reads the current value of a property.
+        /// @returns Whether the object has the property.
+        static bool read(const GuiObject& obj, TweenType type, double* from, bool& isScaled);
+
+        /// @brief Starts a tween once the end value is known.
+        TweenHandle begin(const std::shared_ptr<GuiObject>& obj, TweenType type, const double* to, bool isScaled,
+            double duration, EasingCurve curve);
+
+        /// @brief Writes the current value of the tween at an index into its object.
+        void apply(size_t index, Reserved::LayoutStore& store);
+
+        /// @brief Removes the tween at an index, moving the last one into its place.
+        void remove(size_t index);
+    };
+}
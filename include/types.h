@@ -27,6 +27,11 @@
 #include <sstream>
 #include <stack>
 #include <cstdint>
+#include <list>
+#include <map>
+#include <tuple>
+#include <typeinfo>
+#include <string_view>
 
 namespace GUILib {
 
@@ -43,4 +48,22 @@ namespace GUILib {
         BOTTOM
     };
 
+    /// @brief The property of an object a tween drives.
+    enum class TweenType : uint8_t {
+        SIZE,
+        POSITION,
+        /// @brief The pivot offset, see GuiObject::setPivotOffset().
+        PIVOT,
+        /// @brief The rotation, in degrees.
+        ROTATION,
+        /// @brief The main color: of the frame, of the button or of the box.
+        COLOR,
+        /// @brief The color of the text, for objects with a text.
+        TEXT_COLOR,
+        /// @brief The alpha of every color of the object, from 0 to 255. Starts from the alpha of the main color.
+        ALPHA,
+        /// @brief The scroll position of a scrolling frame, in pixels.
+        SCROLL
+    };
+
 }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "types.h"
+
+// The widest instruction set the kernel is built for. Define GUILIB_NO_SIMD to only build the scalar loop.
+#if !defined(GUILIB_NO_SIMD) && defined(__AVX2__)
+#define GUILIB_UNIT_KERNEL_AVX2 1
+#elif !defined(GUILIB_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GUILIB_UNIT_KERNEL_SSE2 1
+#endif
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief Units of objects to place within their parents, one array per field, all of the same length.
+        /// A unit scales with the parent where its mask is all ones, and is in pixels where it's zero.
+        struct UnitBatch {
+            const double* positionX;
+            const double* positionY;
+            const std::uint64_t* positionMask;
+            const double* sizeX;
+            const double* sizeY;
+            const std::uint64_t* sizeMask;
+
+            /// @brief The absolute position and size of the parents.
+            const double* parentX;
+            const double* parentY;
+            const double* parentW;
+            const double* parentH;
+            /// @brief The content offset of the parents, subtracted from the position.
+            const double* offsetX;
+            const double* offsetY;
+
+            /// @brief Set to the absolute position and size.
+            double* x;
+            double* y;
+            double* w;
+            double* h;
+            /// @brief Set to the absolute position and size, truncated like a cast to int.
+            int* rectX;
+            int* rectY;
+            int* rectW;
+            int* rectH;
+        };
+
+        /// @brief Places objects within their parents, several at once where the instruction set allows it.
+        /// Gives the same results as placing them one at a time.
+        /// @param batch The units and the outputs.
+        /// @param count The amount of objects.
+        void resolveUnits(const UnitBatch& batch, size_t count);
+
+        /// @brief Returns the instruction set resolveUnits() was built for: "AVX2", "SSE2" or "scalar".
+        [[nodiscard]] std::string_view getUnitKernelName();
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "types.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace GUILib {
+
+    namespace Reserved {
+
+        /// @brief A fixed set of background threads running jobs in submission order.
+        /// Jobs must not touch the renderer, SDL rendering calls belong to the render thread.
+        class WorkerPool {
+        public:
+            /// @brief Returns the pool shared by the library, started on first use.
+            /// @returns The pool.
+            static WorkerPool& get();
+
+            /// @brief Queues a job for a worker thread.
+            /// @param job The job.
+            void submit(std::function<void()> job);
+
+            /// @brief Returns the amount of jobs waiting for a worker.
+            [[nodiscard]] size_t pending();
+
+            /// @brief Returns the amount of worker threads.
+            [[nodiscard]] size_t size() const;
+
+            /// @brief Starts the worker threads.
+            /// @param threadCount The amount of threads, at least one.
+            explicit WorkerPool(size_t threadCount);
+            /// @brief Drops the queued jobs and waits for the running ones.
+            ~WorkerPool();
+
+            WorkerPool(const WorkerPool&) = delete;
+            WorkerPool& operator=(const WorkerPool&) = delete;
+
+        private:
+            std::vector<std::thread> workers;
+            std::deque<std::function<void()>> jobs;
+            std::mutex mutex;
+            std::condition_variable available;
+            bool stopping = false;
+
+            void work();
+        };
+    }
+}
@@ -23,9 +23,9 @@ void GUILib::ComboBox::initialize(SDL_Renderer* renderer)
 
     optionBox->setParent(mainButton);
 
-    mainButton->on("onClick", std::function([this](int, int) {
+    mainButton->onClick.connect([this](int, int) {
         isOptionBoxShown = !isOptionBoxShown;
-    }));
+    });
 
     addOption("");
 }
@@ -42,7 +42,7 @@ void GUILib::ComboBox::addOption(const std::string& optionName)
 
     option->setText(optionName.empty() ? "None" : optionName);
     option->initialize(ref);
-    option->on("onClick", std::function([this, option, optionName](int, int) {
+    option->onClick.connect([this, option, optionName](int, int) {
         if (optionName.empty()) {
             selectedOption = "";
             isOptionBoxShown = false;
@@ -50,7 +50,7 @@ void GUILib::ComboBox::addOption(const std::string& optionName)
         }
         selectedOption = option->getText();
         isOptionBoxShown = false;
-    }));
+    });
 
     options.push_back(option);
 }
@@ -80,9 +80,9 @@ void GUILib::ComboBox::removeOptionByName(const std::string& text)
     }
 }
 
-void GUILib::ComboBox::handleEvent(const SDL_Event& e) 
+void GUILib::ComboBox::processEvent(const SDL_Event& e) 
 {
-    Frame::handleEvent(e);
+    Frame::processEvent(e);
 
     const SDL_Rect mainButtonRect = mainButton->getRect();
     const double scrollbarWidth = 0.05 * mainButtonRect.w;
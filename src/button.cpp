@@ -1,4 +1,4 @@
-#include "Button.h"
+#include "button.h"
 
 using namespace GUILib;
 
@@ -18,42 +18,48 @@ Button::Button(
 
 bool Button::isClicked(int x, int y) const
 {
-    return (x > objRect.x &&
-        x < (objRect.x + objRect.w) &&
-        y > objRect.y &&
-        y < (objRect.y + objRect.h));
+    const SDL_Rect rect = getRect();
+    return (x > rect.x &&
+        x < (rect.x + rect.w) &&
+        y > rect.y &&
+        y < (rect.y + rect.h));
 }
 
 void Button::checkHover(int mouseX, int mouseY)
 {
+    const bool wasHovered = hovered;
     hovered = isClicked(mouseX, mouseY);
+    if (hovered != wasHovered) invalidateRender();
 }
 
-void Button::handleEvent(const SDL_Event& e)
+void Button::processEvent(const SDL_Event& e)
 {
     if (!active || !visible) return;
 
-    GuiObject::handleEvent(e);
-    int x, y;
-    SDL_PumpEvents();
-    SDL_GetMouseState(&x, &y);
+    GuiObject::processEvent(e);
 
-    if (!((e.type == SDL_MOUSEMOTION || e.type == SDL_MOUSEBUTTONDOWN) && active && visible)) {
+    if (!(e.type == SDL_MOUSEMOTION || e.type == SDL_MOUSEBUTTONDOWN)) {
         return;
     }
-    if (x > objRect.x && x < (objRect.x + objRect.w) &&
-        y > objRect.y && y < (objRect.y + objRect.h)) {
+
+    // The position is carried by the event itself, no need to poll the mouse state
+    SDL_Point pointer;
+    Reserved::getEventPointer(e, pointer);
+    const auto [x, y] = pointer;
+    const bool wasHovered = hovered;
+    if (isClicked(x, y)) {
         hovered = true;
         if (hoverAction) hoverAction();
-        trigger("onHover", x, y);
+        onHover.fire(x, y);
     }
     else {
         hovered = false;
     }
+    if (hovered != wasHovered) invalidateRender();
     if (e.type == SDL_MOUSEBUTTONDOWN && hovered &&
         e.button.button == SDL_BUTTON_LEFT) {
         if (buttonAction) buttonAction();
-        trigger("onClick", x, y);
+        onClick.fire(x, y);
     }
 }
 
@@ -72,6 +78,13 @@ bool Button::isHovered() const
     return hovered;
 }
 
+Reserved::SignalBase* Button::findSignal(std::string_view eventName)
+{
+    if (eventName == "onHover") return &onHover;
+    if (eventName == "onClick") return &onClick;
+    return GuiObject::findSignal(eventName);
+}
+
 Button& Button::operator=(const Button& other)
 {
     // Seriously, nothing is worth copying
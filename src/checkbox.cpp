@@ -1,4 +1,4 @@
-#include "Button.h"
+#include "button.h"
 
 GUILib::CheckBox::CheckBox():
     boxSymbol('X'),
@@ -33,40 +33,55 @@ GUILib::CheckBox::CheckBox(
 
 void GUILib::CheckBox::changeSymbol(const char& symbol) {
     boxSymbol = symbol;
-    if (isChecked())
-        text = boxSymbol;
+    if (isChecked()) refreshSymbol();
 }
 
-void GUILib::CheckBox::handleEvent(const SDL_Event& e) {
-    if (!active || !visible) return;
+void GUILib::CheckBox::refreshSymbol()
+{
+    text = isChecked() ? std::string(1, boxSymbol) : "";
+    // Initializing invalidates the render, the recorded draws would keep the old symbol otherwise
+    initialize(ref);
+}
 
-    int x, y;
-    SDL_PumpEvents();
-    SDL_GetMouseState(&x, &y);
+void GUILib::CheckBox::processEvent(const SDL_Event& e) {
+    if (!active || !visible) return;
 
     // Suppress this warning please, I didn't mean to call the direct superclass
-    GuiObject::handleEvent(e);
+    GuiObject::processEvent(e);
 
-    if (!((e.type == SDL_MOUSEMOTION || e.type == SDL_MOUSEBUTTONDOWN) && (active && visible))) {
+    if (!(e.type == SDL_MOUSEMOTION || e.type == SDL_MOUSEBUTTONDOWN)) {
         return;
     }
-    if (x > objRect.x && x < (objRect.x + objRect.w) &&
-        y > objRect.y && y < (objRect.y + objRect.h)) {
+
+    SDL_Point pointer;
+    Reserved::getEventPointer(e, pointer);
+    const auto [x, y] = pointer;
+    const bool wasHovered = hovered;
+    if (isClicked(x, y)) {
         hovered = true;
     }
     else {
         hovered = false;
     }
+    if (hovered != wasHovered) invalidateRender();
     if (e.type == SDL_MOUSEBUTTONDOWN && hovered) {
         toggleChecked();
-        text = isChecked() ? std::string(1, boxSymbol) : "";
-        initialize(ref);
-        trigger("onClick");
+        onToggle.fire();
     }
 }
 
-void GUILib::CheckBox::toggleChecked() { checked = !checked; }
-void GUILib::CheckBox::toggleChecked(bool val) { checked = val; }
+void GUILib::CheckBox::toggleChecked()
+{
+    checked = !checked;
+    refreshSymbol();
+}
+
+void GUILib::CheckBox::toggleChecked(bool val)
+{
+    if (checked == val) return;
+    checked = val;
+    refreshSymbol();
+}
 bool GUILib::CheckBox::isChecked() const { return checked; }
 char GUILib::CheckBox::getSymbol() const { return boxSymbol; }
 
@@ -85,3 +100,9 @@ GUILib::CheckBox& GUILib::CheckBox::operator=(const CheckBox& other)
 
     return *this;
 }
+
+GUILib::Reserved::SignalBase* GUILib::CheckBox::findSignal(std::string_view eventName)
+{
+    if (eventName == "onClick") return &onToggle;
+    return TextButton::findSignal(eventName);
+}
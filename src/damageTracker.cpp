@@ -0,0 +1,76 @@
+#include "damageTracker.h"
+
+using namespace GUILib::Reserved;
+
+namespace {
+    std::unordered_map<SDL_Renderer*, std::unique_ptr<DamageTracker>>& damageTrackers()
+    {
+        static std::unordered_map<SDL_Renderer*, std::unique_ptr<DamageTracker>> trackers;
+        return trackers;
+    }
+}
+
+DamageTracker& DamageTracker::get(SDL_Renderer* r)
+{
+    auto& tracker = damageTrackers()[r];
+    if (!tracker) tracker = std::make_unique<DamageTracker>();
+    return *tracker;
+}
+
+void DamageTracker::releaseRenderer(SDL_Renderer* r)
+{
+    damageTrackers().erase(r);
+}
+
+void DamageTracker::add(const SDL_Rect& rect)
+{
+    if (full || rect.w <= 0 || rect.h <= 0) return;
+
+    // Swallow every area the new one touches, the grown area may reach further ones
+    SDL_Rect merged = rect;
+    for (size_t i = 0; i < rects.size();) {
+        if (SDL_HasIntersection(&rects[i], &merged)) {
+            SDL_UnionRect(&rects[i], &merged, &merged);
+            rects[i] = rects.back();
+            rects.pop_back();
+            i = 0;
+        }
+        else ++i;
+    }
+    rects.push_back(merged);
+
+    if (rects.size() > MAX_RECTS) {
+        SDL_Rect bounds = rects.front();
+        for (const auto& r : rects) SDL_UnionRect(&bounds, &r, &bounds);
+        rects.assign(1, bounds);
+    }
+}
+
+void DamageTracker::addAll()
+{
+    full = true;
+    rects.clear();
+}
+
+bool DamageTracker::isEmpty() const
+{
+    return !full && rects.empty();
+}
+
+std::vector<SDL_Rect> DamageTracker::take(const SDL_Rect& bounds)
+{
+    std::vector<SDL_Rect> visible;
+    if (full) {
+        if (bounds.w > 0 && bounds.h > 0) visible.push_back(bounds);
+    }
+    else {
+        for (const auto& r : rects) {
+            SDL_Rect clipped;
+            if (SDL_IntersectRect(&r, &bounds, &clipped)) visible.push_back(clipped);
+        }
+    }
+
+    rects.clear();
+    full = false;
+    return visible;
+}
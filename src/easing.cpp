@@ -0,0 +1,131 @@
+#include "easing.h"
+
+using namespace GUILib;
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double BACK = 1.70158;
+
+    double bounceOut(double x)
+    {
+        constexpr double n = 7.5625, d = 2.75;
+        if (x < 1.0 / d) return n * x * x;
+        if (x < 2.0 / d) { x -= 1.5 / d; return n * x * x + 0.75; }
+        if (x < 2.5 / d) { x -= 2.25 / d; return n * x * x + 0.9375; }
+        x -= 2.625 / d;
+        return n * x * x + 0.984375;
+    }
+
+    /// @brief The built-in curves, in the order of EasingCurve.
+    double builtIn(EasingCurve curve, double x)
+    {
+        switch (curve) {
+        case EasingCurve::LINEAR: return x;
+        case EasingCurve::QUAD_IN: return x * x;
+        case EasingCurve::QUAD_OUT: return 1 - (1 - x) * (1 - x);
+        case EasingCurve::QUAD_IN_OUT: return x < 0.5 ? 2 * x * x : 1 - std::pow(-2 * x + 2, 2) / 2;
+        case EasingCurve::CUBIC_IN: return x * x * x;
+        case EasingCurve::CUBIC_OUT: return 1 - std::pow(1 - x, 3);
+        case EasingCurve::CUBIC_IN_OUT: return x < 0.5 ? 4 * x * x * x : 1 - std::pow(-2 * x + 2, 3) / 2;
+        case EasingCurve::BACK_IN: return (BACK + 1) * x * x * x - BACK * x * x;
+        case EasingCurve::BACK_OUT: return 1 + (BACK + 1) * std::pow(x - 1, 3) + BACK * std::pow(x - 1, 2);
+        case EasingCurve::BACK_IN_OUT: {
+            constexpr double c = BACK * 1.525;
+            return x < 0.5
+                ? std::pow(2 * x, 2) * ((c + 1) * 2 * x - c) / 2
+                : (std::pow(2 * x - 2, 2) * ((c + 1) * (2 * x - 2) + c) + 2) / 2;
+        }
+        case EasingCurve::ELASTIC_IN:
+            if (x <= 0 || x >= 1) return x;
+            return -std::pow(2, 10 * x - 10) * std::sin((x * 10 - 10.75) * (2 * PI / 3));
+        case EasingCurve::ELASTIC_OUT:
+            if (x <= 0 || x >= 1) return x;
+            return std::pow(2, -10 * x) * std::sin((x * 10 - 0.75) * (2 * PI / 3)) + 1;
+        case EasingCurve::ELASTIC_IN_OUT:
+            if (x <= 0 || x >= 1) return x;
+            return x < 0.5
+                ? -(std::pow(2, 20 * x - 10) * std::sin((20 * x - 11.125) * (2 * PI / 4.5))) / 2
+                : std::pow(2, -20 * x + 10) * std::sin((20 * x - 11.125) * (2 * PI / 4.5)) / 2 + 1;
+        case EasingCurve::BOUNCE_IN: return 1 - bounceOut(1 - x);
+        case EasingCurve::BOUNCE_OUT: return bounceOut(x);
+        case EasingCurve::BOUNCE_IN_OUT: return x < 0.5 ? (1 - bounceOut(1 - 2 * x)) / 2 : (1 + bounceOut(2 * x - 1)) / 2;
+        }
+        return x;
+    }
+
+    constexpr size_t BUILT_IN_COUNT = static_cast<size_t>(EasingCurve::BOUNCE_IN_OUT) + 1;
+    constexpr size_t STRIDE = Easing::INTERVALS + 1;
+
+    void sample(std::vector<double>& tables, const std::function<double(double)>& curve)
+    {
+        for (size_t i = 0; i <= Easing::INTERVALS; ++i)
+            tables.push_back(curve(static_cast<double>(i) / static_cast<double>(Easing::INTERVALS)));
+    }
+}
+
+std::vector<double>& Easing::tables()
+{
+    static std::vector<double> samples = [] {
+        std::vector<double> built;
+        built.reserve(BUILT_IN_COUNT * STRIDE);
+        for (size_t curve = 0; curve < BUILT_IN_COUNT; ++curve)
+            sample(built, [curve](double x) { return builtIn(static_cast<EasingCurve>(curve), x); });
+        return built;
+    }();
+    return samples;
+}
+
+EasingCurve Easing::registerCurve(const std::function<double(double)>& curve)
+{
+    auto& samples = tables();
+    const size_t index = samples.size() / STRIDE;
+    if (!curve || index > UINT16_MAX) return EasingCurve::LINEAR;
+
+    sample(samples, curve);
+    return static_cast<EasingCurve>(index);
+}
+
+EasingCurve Easing::registerCubicBezier(double x1, double y1, double x2, double y2)
+{
+    x1 = std::clamp(x1, 0.0, 1.0);
+    x2 = std::clamp(x2, 0.0, 1.0);
+
+    // Each coordinate is a cubic polynomial of the curve parameter t
+    const double cx = 3 * x1, bx = 3 * (x2 - x1) - cx, ax = 1 - cx - bx;
+    const double cy = 3 * y1, by = 3 * (y2 - y1) - cy, ay = 1 - cy - by;
+    const auto curveX = [=](double t) { return ((ax * t + bx) * t + cx) * t; };
+    const auto curveY = [=](double t) { return ((ay * t + by) * t + cy) * t; };
+    const auto slopeX = [=](double t) { return (3 * ax * t + 2 * bx) * t + cx; };
+
+    return registerCurve([=](double x) {
+        // Newton's method first, bisection where the slope is too flat for it. x is monotonic in t
+        double t = x;
+        for (int i = 0; i < 8; ++i) {
+            const double error = curveX(t) - x, slope = slopeX(t);
+            if (std::abs(error) < 1e-9) return curveY(t);
+            if (std::abs(slope) < 1e-6) break;
+            t -= error / slope;
+        }
+
+        double low = 0, high = 1;
+        t = x;
+        for (int i = 0; i < 64 && high - low > 1e-12; ++i) {
+            if (curveX(t) < x) low = t;
+            else high = t;
+            t = (low + high) / 2;
+        }
+        return curveY(t);
+    });
+}
+
+const double* Easing::getSamples(EasingCurve curve)
+{
+    const auto& samples = tables();
+    const size_t index = static_cast<size_t>(curve);
+    return samples.data() + (index < samples.size() / STRIDE ? index : 0) * STRIDE;
+}
+
+double Easing::evaluate(EasingCurve curve, double progress)
+{
+    return interpolate(getSamples(curve), progress);
+}
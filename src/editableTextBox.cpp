@@ -1,138 +1,248 @@
-#include "TextBox.h"
+#include "textBox.h"
+#include "glyphAtlas.h"
+#include "renderList.h"
 
-namespace {
-    std::pair<size_t, size_t> getCursorPos(
-        const std::vector<std::string>& lines,
-        size_t cursorPos, 
-        const std::string& fullText) 
-    {
-        if (lines.empty() || fullText.empty()) return { 0, 0 };
-        size_t globalIndex = 0;
-        for (size_t i = 0; i < lines.size(); ++i) {
-            size_t lineLen = lines[i].size();
-            // Is the cursor is within this line?
-            if (cursorPos <= globalIndex + lineLen) {
-                return { i, cursorPos - globalIndex };
-            }
-            // Account for the newline character that was split
-            globalIndex += lineLen;
-            if (globalIndex < fullText.size() && fullText[globalIndex] == '\n') {
-                ++globalIndex;
-                // Prob in the new line
-                if (cursorPos == globalIndex) {
-                    return { i + 1, 0 };
-                }
-            }
+std::pair<size_t, size_t> GUILib::EditableTextBox::cursorToLine(size_t position) const
+{
+    const auto& lines = wrapper.getLines();
+    if (lines.empty() || wrapper.paragraphCount() == 0) return { 0, 0 };
+
+    // The paragraph is found in O(log n), then only its wrapped lines are walked
+    const size_t paragraph = std::min(buffer.lineOf(position), wrapper.paragraphCount() - 1);
+    size_t column = position - std::min(position, buffer.lineStart(paragraph));
+    size_t line = wrapper.paragraphFirstLine(paragraph);
+    const size_t end = line + wrapper.paragraphLineCount(paragraph);
+
+    // A position between two wrapped lines stays at the end of the first one
+    while (line + 1 < end && column > lines[line].size()) {
+        column -= lines[line].size();
+        ++line;
+    }
+    return { line, std::min(column, lines[line].size()) };
+}
+
+size_t GUILib::EditableTextBox::lineToCursor(size_t line, size_t column) const
+{
+    const auto& lines = wrapper.getLines();
+    if (lines.empty()) return 0;
+    line = std::min(line, lines.size() - 1);
+
+    const size_t paragraph = wrapper.paragraphOfLine(line);
+    size_t position = buffer.lineStart(paragraph);
+    for (size_t i = wrapper.paragraphFirstLine(paragraph); i < line; ++i) {
+        position += lines[i].size();
+    }
+    return std::min(position + std::min(column, lines[line].size()), buffer.size());
+}
+
+void GUILib::EditableTextBox::markEdited(size_t paragraph, size_t removed, size_t inserted)
+{
+    size_t end = paragraph + inserted + 1;
+    if (hasPendingEdit) {
+        // Pending paragraphs after the edit moved with it, the ones inside are covered by it
+        if (pendingEnd > paragraph + removed + 1) {
+            end = std::max(end, pendingEnd + inserted - removed);
         }
-        // Fallback at the end
-        return { lines.size() - 1, lines.back().size() };
+        pendingFirst = std::min(pendingFirst, paragraph);
+    }
+    else {
+        pendingFirst = paragraph;
+        hasPendingEdit = true;
     }
+    pendingEnd = end;
+    pendingDelta += static_cast<std::ptrdiff_t>(inserted) - static_cast<std::ptrdiff_t>(removed);
+}
 
-    size_t getGlobalCursorPos(
-        const std::vector<std::string>& lines,
-        size_t lineIdx, size_t colIdx,
-        const std::string& fullText) 
-    {
-        size_t globalIndex = 0;
-        size_t textIdx = 0;
-        for (size_t i = 0; i < lines.size(); ++i) {
-            if (i == lineIdx) {
-                return globalIndex + std::min(colIdx, lines[i].size());
-            }
-            globalIndex += lines[i].size();
-            if (textIdx + lines[i].size() < fullText.size() && fullText[globalIndex] == '\n') {
-                ++globalIndex;
-            }
-            textIdx += lines[i].size();
-            if (textIdx < fullText.size() && fullText[textIdx] == '\n') {
-                ++textIdx;
-            }
+void GUILib::EditableTextBox::insertText(size_t position, std::string_view str)
+{
+    if (str.empty()) return;
+    markEdited(buffer.lineOf(position), 0, static_cast<size_t>(std::count(str.begin(), str.end(), '\n')));
+    buffer.insert(position, str);
+    invalidateText();
+}
+
+void GUILib::EditableTextBox::eraseText(size_t position, size_t count)
+{
+    if (position >= buffer.size() || count == 0) return;
+    count = std::min(count, buffer.size() - position);
+
+    const size_t first = buffer.lineOf(position);
+    markEdited(first, buffer.lineOf(position + count) - first, 0);
+    buffer.erase(position, count);
+    invalidateText();
+}
+
+void GUILib::EditableTextBox::wrapText(int maxWidth)
+{
+    if (wrapAll || !wrapper.matches(textFont, maxWidth)) {
+        std::vector<std::string> paragraphs;
+        paragraphs.reserve(buffer.lineCount());
+        for (size_t i = 0; i < buffer.lineCount(); ++i) {
+            paragraphs.push_back(buffer.line(i));
+        }
+        wrapper.assignParagraphs(paragraphs, textFont, maxWidth);
+    }
+    else if (hasPendingEdit) {
+        std::vector<std::string> paragraphs;
+        for (size_t i = pendingFirst; i < pendingEnd; ++i) {
+            paragraphs.push_back(buffer.line(i));
         }
-        return fullText.size();
+        const auto replaced = static_cast<std::ptrdiff_t>(pendingEnd - pendingFirst) - pendingDelta;
+        wrapper.replaceParagraphs(pendingFirst, static_cast<size_t>(replaced), paragraphs);
     }
+
+    wrapAll = false;
+    hasPendingEdit = false;
+    pendingDelta = 0;
+}
+
+size_t GUILib::EditableTextBox::textLength() const
+{
+    return buffer.size();
+}
+
+std::string GUILib::EditableTextBox::getText() const
+{
+    return buffer.toString();
+}
+
+void GUILib::EditableTextBox::setText(const std::string& str)
+{
+    buffer.assign(str);
+    cursorPosition = std::min(cursorPosition, buffer.size());
+    wrapAll = true;
+    hasPendingEdit = false;
+    pendingDelta = 0;
+    invalidateText();
+}
+
+bool GUILib::EditableTextBox::isFocusable() const
+{
+    return true;
+}
+
+bool GUILib::EditableTextBox::acceptsTextInput() const
+{
+    return editable;
+}
+
+bool GUILib::EditableTextBox::handlesTab() const
+{
+    return editable && indentationSize > 0;
 }
 
-void GUILib::EditableTextBox::handleEvent(const SDL_Event& e)
+void GUILib::EditableTextBox::processEvent(const SDL_Event& e)
 {
-    TextBox::handleEvent(e);
+    TextBox::processEvent(e);
     if (!editable) return;
-    cursorPosition = std::clamp(cursorPosition, size_t(0), text.size());
+    cursorPosition = std::clamp(cursorPosition, size_t(0), buffer.size());
     if (e.type == SDL_KEYDOWN) {
         if (auto it = keyActions.find(e.key.keysym.sym); it != keyActions.end()) {
             it->second(); // Call the corresponding action
-            trigger("onSpecialKeyInput");
+            onSpecialKeyInput.fire();
         }
     }
     else if (e.type == SDL_TEXTINPUT) {
-        insertCharacter(e.text.text[0]); // Insert the input character
-        trigger("onKeyInput", e.text.text[0]);
+        // A keystroke may give several bytes, a whole UTF-8 character or what an input method composed
+        const std::string input(e.text.text);
+        insertInput(input);
+        if (!input.empty()) onKeyInput.fire(input.front());
+        onTextInput.fire(input);
     }
+    else return;
+    // The cursor may have moved
+    invalidateRender();
+}
+
+size_t GUILib::EditableTextBox::previousCharacter(size_t position) const
+{
+    if (position == 0) return 0;
+    // Continuation bytes look like 10xxxxxx
+    do --position;
+    while (position > 0 && (static_cast<unsigned char>(buffer[position]) & 0xC0) == 0x80);
+    return position;
+}
+
+size_t GUILib::EditableTextBox::nextCharacter(size_t position) const
+{
+    if (position >= buffer.size()) return buffer.size();
+    do ++position;
+    while (position < buffer.size() && (static_cast<unsigned char>(buffer[position]) & 0xC0) == 0x80);
+    return position;
 }
 
 void GUILib::EditableTextBox::handleBackspace()
 {
     if (cursorPosition > 0) {
-	    text.erase(cursorPosition - 1, 1);
-	    cursorPosition--;
+        const size_t start = previousCharacter(cursorPosition);
+	    eraseText(start, cursorPosition - start);
+	    cursorPosition = start;
     }
 }
 
 void GUILib::EditableTextBox::handleDelete()
 {
-    if (cursorPosition < text.size()) {
-        text.erase(cursorPosition, 1);
+    if (cursorPosition < buffer.size()) {
+        eraseText(cursorPosition, nextCharacter(cursorPosition) - cursorPosition);
     }
 }
 
 void GUILib::EditableTextBox::moveCursorLeft()
 {
-    if (cursorPosition > 0) {
-        cursorPosition--;
-    }
+    cursorPosition = previousCharacter(cursorPosition);
 }
 
 void GUILib::EditableTextBox::moveCursorRight()
 {
-    if (cursorPosition < text.size()) {
-        cursorPosition++;
-    }
+    cursorPosition = nextCharacter(cursorPosition);
 }
 
 void GUILib::EditableTextBox::moveCursorUp() {
-    auto [lineIdx, colIdx] = getCursorPos(lines, cursorPosition, text);
+    refreshTextLayout();
+    auto [lineIdx, colIdx] = cursorToLine(cursorPosition);
 
     if (lineIdx == 0) return; // First line
     if (preferredColumn == 0) preferredColumn = colIdx;
 
-    size_t newLineIdx = lineIdx - 1;
-    size_t newColIdx = std::min(preferredColumn, lines[newLineIdx].size());
-    cursorPosition = getGlobalCursorPos(lines, newLineIdx, newColIdx, text);
+    cursorPosition = lineToCursor(lineIdx - 1, preferredColumn);
 }
 
 void GUILib::EditableTextBox::moveCursorDown() {
-    auto [lineIdx, colIdx] = getCursorPos(lines, cursorPosition, text);
+    refreshTextLayout();
+    auto [lineIdx, colIdx] = cursorToLine(cursorPosition);
 
-    if (lineIdx + 1 >= lines.size()) return; // Last line
+    if (lineIdx + 1 >= wrapper.getLines().size()) return; // Last line
     if (preferredColumn == 0) preferredColumn = colIdx;
 
-    size_t newLineIdx = lineIdx + 1;
-    size_t newColIdx = std::min(preferredColumn, lines[newLineIdx].size());
-    cursorPosition = getGlobalCursorPos(lines, newLineIdx, newColIdx, text);
+    cursorPosition = lineToCursor(lineIdx + 1, preferredColumn);
+}
+
+void GUILib::EditableTextBox::insertInput(std::string_view input)
+{
+    // Plain runs go in at once, the characters driving the indentation one by one
+    size_t runStart = 0;
+    for (size_t i = 0; i <= input.size(); ++i) {
+        if (i < input.size() && input[i] != '\n' && !(input[i] == '}' && shouldIndent)) continue;
+
+        if (i > runStart) {
+            insertText(cursorPosition, input.substr(runStart, i - runStart));
+            cursorPosition += i - runStart;
+        }
+        if (i < input.size()) insertCharacter(input[i]);
+        runStart = i + 1;
+    }
 }
 
 void GUILib::EditableTextBox::insertCharacter(char c)
 {
-    // Arguably the worst way to handle it
-    if (c == '\n') {
-        // Start of the current line
-        size_t lineStart = text.rfind('\n', cursorPosition == 0 ? 0 : cursorPosition - 1);
-        if (lineStart == std::string::npos) lineStart = 0;
-        else lineStart += 1; // Move past the '\n'
+    // Start of the current line
+    const size_t lineStart = buffer.lineStart(buffer.lineOf(cursorPosition));
 
+    if (c == '\n') {
         // collect indentation (spaces/tabs) from the current line
         std::string indentation;
-        while (lineStart + indentation.size() < text.size()) {
-            char ch = text[lineStart + indentation.size()];
+        while (lineStart + indentation.size() < buffer.size()) {
+            char ch = buffer[lineStart + indentation.size()];
             if (ch == ' ' || ch == '\t')
                 indentation += ch;
             else
@@ -141,58 +251,52 @@ void GUILib::EditableTextBox::insertCharacter(char c)
 
         // Check the last non-whitespace character before the cursor
         size_t lastCharPos = cursorPosition;
-        while (lastCharPos > lineStart && (text[lastCharPos - 1] == ' ' || text[lastCharPos - 1] == '\t'))
+        while (lastCharPos > lineStart && (buffer[lastCharPos - 1] == ' ' || buffer[lastCharPos - 1] == '\t'))
             --lastCharPos;
-        char lastChar = (lastCharPos > lineStart) ? text[lastCharPos - 1] : '\0';
-        
-        text.insert(cursorPosition, 1, '\n');
-        cursorPosition++;
+        char lastChar = (lastCharPos > lineStart) ? buffer[lastCharPos - 1] : '\0';
 
         // if last non-whitespace char is {, add extra indent
         if (lastChar == '{' && shouldIndent) {
             indentation += std::string(indentationSize, ' ');
         }
-        
-        text.insert(cursorPosition, indentation);
-        cursorPosition += indentation.size();
+
+        const std::string inserted = '\n' + indentation;
+        insertText(cursorPosition, inserted);
+        cursorPosition += inserted.size();
     }
     // Auto unindent
     else if (c == '}' && shouldIndent) {
-        // Find the start of the current line
-        size_t lineStart = text.rfind('\n', cursorPosition == 0 ? 0 : cursorPosition - 1);
-        if (lineStart == std::string::npos) lineStart = 0;
-        else lineStart += 1;
-
         // If the current line is only indentation, remove one indent before inserting }
         size_t indentEnd = lineStart;
-        while (indentEnd < text.size() && (text[indentEnd] == ' ' || text[indentEnd] == '\t'))
+        while (indentEnd < buffer.size() && (buffer[indentEnd] == ' ' || buffer[indentEnd] == '\t'))
             ++indentEnd;
         if (cursorPosition == indentEnd) {
+            const auto indentLength = static_cast<size_t>(std::max(indentationSize, 0));
             // Remove one indent (tab or 4 spaces or whatever)
             if (indentEnd > lineStart) {
-                if (text[indentEnd - 1] == '\t') {
-                    text.erase(indentEnd - 1, 1);
+                if (buffer[indentEnd - 1] == '\t') {
+                    eraseText(indentEnd - 1, 1);
                     cursorPosition--;
                 }
-                else if (indentEnd - lineStart >= indentationSize &&
-                    text.substr(indentEnd - indentationSize, indentationSize) == std::string(indentationSize, ' ')) {
-                    text.erase(indentEnd - indentationSize, indentationSize);
-                    cursorPosition -= indentationSize;
+                else if (indentEnd - lineStart >= indentLength &&
+                    buffer.substr(indentEnd - indentLength, indentLength) == std::string(indentLength, ' ')) {
+                    eraseText(indentEnd - indentLength, indentLength);
+                    cursorPosition -= indentLength;
                 }
             }
         }
-        text.insert(cursorPosition, 1, c);
+        insertText(cursorPosition, std::string_view(&c, 1));
         cursorPosition++;
     }
     else {
-        text.insert(cursorPosition, 1, c);
+        insertText(cursorPosition, std::string_view(&c, 1));
         cursorPosition++;
     }
 }
 
 void GUILib::EditableTextBox::reset()
 {
-    text.clear();
+    setText("");
     cursorPosition = 0;
 }
 
@@ -303,39 +407,53 @@ bool GUILib::EditableTextBox::isEditable() const
 void GUILib::EditableTextBox::setEditable(bool val)
 {
     editable = val;
-    trigger("onEditableChange");
+    invalidateRender();
+    onEditableChange.fire();
+}
+
+void GUILib::EditableTextBox::focusChanged(bool hasFocus)
+{
+    focused = hasFocus;
+    // Start a blink period, so moving the focus around doesn't catch the cursor hidden
+    cursorVisible = true;
+    lastBlinkTime = std::chrono::steady_clock::now();
+    if (editable) invalidateRender();
 }
 
 void GUILib::EditableTextBox::render()
 {
     TextBox::render();
-    if (!editable) return;
+    // Without the focus, nothing blinks and nothing has to be drawn again
+    if (!editable || !focused) return;
 
     // Update cursor blinking timer
     auto now = std::chrono::steady_clock::now();
-    if (now - lastBlinkTime > std::chrono::milliseconds(500)) {
+    if (now - lastBlinkTime >= std::chrono::milliseconds(500)) {
         cursorVisible = !cursorVisible;
         lastBlinkTime = now;
+        damage();
     }
+    // Draw again when the cursor blinks
+    invalidateRenderAt(lastBlinkTime + std::chrono::milliseconds(500));
 
     if (!cursorVisible || !textFont) return;
 
     // map global cursor position to line and column
-    auto [lineIdx, colIdx] = getCursorPos(lines, cursorPosition, text); // crash??
-    if (lineIdx >= renderedLines.size()) return; // WHY DID THAT BREAK
+    auto [lineIdx, colIdx] = cursorToLine(cursorPosition);
+    if (lineIdx >= renderedLines.size()) return; // Not laid out yet
 
-    const auto& [lineText, linePosition] = renderedLines[lineIdx];
-    std::string beforeCursor = lineText.substr(0, colIdx);
+    const std::string& lineText = wrapper.getLines()[lineIdx];
+    const SDL_Point& linePosition = renderedLines[lineIdx].position;
+    const std::string_view beforeCursor = std::string_view(lineText).substr(0, colIdx);
 
-    int cursorOffsetX = 0;
-    TTF_SizeText(textFont, beforeCursor.c_str(), &cursorOffsetX, nullptr);
+    auto& metrics = Reserved::FontMetrics::get(textFont);
+    const int cursorOffsetX = metrics.measure(beforeCursor);
 
-    int cursorX = linePosition.x + cursorOffsetX;
-    int cursorY = linePosition.y;
-    int height = TTF_FontHeight(textFont);
+    int cursorX = objRect.x + linePosition.x + cursorOffsetX;
+    int cursorY = objRect.y + linePosition.y;
+    int height = metrics.height();
 
-    SDL_SetRenderDrawColor(ref, textColor.r, textColor.g, textColor.b, textColor.a);
-    SDL_RenderDrawLine(ref, cursorX, cursorY, cursorX, cursorY + height);
+    Reserved::RenderList::get(ref).line(textColor, cursorX, cursorY, cursorX, cursorY + height);
 }
 
 bool GUILib::EditableTextBox::getShouldIndent() const {
@@ -352,4 +470,13 @@ void GUILib::EditableTextBox::setShouldIndent(const bool& val) {
 
 void GUILib::EditableTextBox::setIndentationSize(const int& val) {
     indentationSize = val;
-}
\ No newline at end of file
+}
+
+GUILib::Reserved::SignalBase* GUILib::EditableTextBox::findSignal(std::string_view eventName)
+{
+    if (eventName == "onSpecialKeyInput") return &onSpecialKeyInput;
+    if (eventName == "onKeyInput") return &onKeyInput;
+    if (eventName == "onTextInput") return &onTextInput;
+    if (eventName == "onEditableChange") return &onEditableChange;
+    return TextBox::findSignal(eventName);
+}
@@ -0,0 +1,126 @@
+#include "focusManager.h"
+#include "guiobject.h"
+
+using namespace GUILib;
+
+void FocusManager::setFocus(const std::shared_ptr<GuiObject>& obj)
+{
+    const auto previous = focused.lock();
+    if (previous == obj) return;
+
+    // Set first, so a callback asking for the focused object already gets the new one
+    focused = obj;
+    refreshTextInput();
+
+    if (previous) {
+        previous->focusChanged(false);
+        previous->onFocusChange.fire(false);
+    }
+    if (obj) {
+        obj->focusChanged(true);
+        obj->onFocusChange.fire(true);
+    }
+}
+
+std::shared_ptr<GuiObject> FocusManager::getFocused() const
+{
+    return focused.lock();
+}
+
+void FocusManager::dispatch(const SDL_Event& e, const std::vector<std::shared_ptr<GuiObject>>& roots)
+{
+    const auto target = focused.lock();
+    const bool reachable = target && target->isActive() && target->isVisible();
+
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_TAB) {
+        // Ctrl+Tab leaves the objects typing tabs
+        if (!reachable || !target->handlesTab() || (e.key.keysym.mod & KMOD_CTRL)) {
+            moveFocus(roots, (e.key.keysym.mod & KMOD_SHIFT) != 0);
+            return;
+        }
+    }
+    if (!reachable) return;
+
+    // The focused object may have stopped taking text since it got the focus
+    if (e.type == SDL_KEYDOWN) refreshTextInput();
+    target->processEvent(e);
+}
+
+std::shared_ptr<GuiObject> FocusManager::moveFocus(const std::vector<std::shared_ptr<GuiObject>>& roots, bool backwards)
+{
+    collect(roots);
+    if (candidates.empty()) {
+        setFocus(nullptr);
+        return nullptr;
+    }
+
+    const size_t count = candidates.size();
+    const auto current = std::find(candidates.begin(), candidates.end(), focused.lock().get());
+    size_t next;
+    if (current == candidates.end()) next = backwards ? count - 1 : 0;
+    else {
+        const size_t index = static_cast<size_t>(current - candidates.begin());
+        next = backwards ? (index + count - 1) % count : (index + 1) % count;
+    }
+
+    auto obj = candidates[next]->shared_from_this();
+    setFocus(obj);
+    return obj;
+}
+
+void FocusManager::setTabOrder(const std::vector<std::shared_ptr<GuiObject>>& order)
+{
+    tabOrder.assign(order.begin(), order.end());
+}
+
+void FocusManager::refreshTextInput() const
+{
+    const auto obj = focused.lock();
+    const bool wanted = obj && obj->acceptsTextInput();
+    if (wanted == (SDL_IsTextInputActive() == SDL_TRUE)) return;
+
+    if (wanted) SDL_StartTextInput();
+    else SDL_StopTextInput();
+}
+
+bool FocusManager::isReachable(const GuiObject& obj)
+{
+    if (!obj.isVisible() || !obj.isActive()) return false;
+    for (auto parent = obj.getParent().lock(); parent; parent = parent->getParent().lock()) {
+        if (!parent->isVisible() || !parent->isActive() || !parent->getChildrenRenderingState()) return false;
+    }
+    return true;
+}
+
+void FocusManager::collect(const std::vector<std::shared_ptr<GuiObject>>& roots)
+{
+    candidates.clear();
+
+    if (!tabOrder.empty()) {
+        for (const auto& weak : tabOrder) {
+            const auto obj = weak.lock();
+            if (obj && obj->isFocusable() && isReachable(*obj)) candidates.push_back(obj.get());
+        }
+        return;
+    }
+
+    // Depth first, parents before their children and children in order, the way they are drawn
+    stack.clear();
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) {
+        if (*it) stack.push_back(it->get());
+    }
+    while (!stack.empty()) {
+        GuiObject* obj = stack.back();
+        stack.pop_back();
+        // Like for pointer events, hidden and inactive objects hide their whole subtree
+        if (!obj->isVisible() || !obj->isActive()) continue;
+
+        if (obj->isFocusable()) candidates.push_back(obj);
+        if (!obj->getChildrenRenderingState()) continue;
+
+        const auto& children = obj->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if (*it) stack.push_back(it->get());
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "frame.h"
+#include "renderList.h"
 
 GUILib::Frame::Frame() :
     frameColor() {}
@@ -15,20 +16,38 @@ GUILib::Frame::Frame(
 
 void GUILib::Frame::render()
 {
+    update(ref);
     if (!shouldRender()) return;
 
-	const auto frameTexture = Reserved::createSolidBoxTexture(ref, frameColor, objRect.w, objRect.h);
-
-    if (frameTexture) {
-		SDL_RenderCopyEx(ref, frameTexture.get(), nullptr, &objRect, degreeRotation, nullptr, SDL_FLIP_NONE);
-    }
+    renderBox();
 
     GuiObject::render();
 }
 
-void GUILib::Frame::setFrameColor(const SDL_Color& color) { frameColor = color; }
+void GUILib::Frame::renderBox()
+{
+    Reserved::renderSolidBox(ref, frameColor, objRect, getRotation());
+}
+
+void GUILib::Frame::setFrameColor(const SDL_Color& color) { frameColor = color; invalidateRender(); }
 SDL_Color GUILib::Frame::getFrameColor() const { return frameColor; }
 
+bool GUILib::Frame::getTweenValue(TweenType type, double* values) const
+{
+    if (type != TweenType::COLOR) return GuiObject::getTweenValue(type, values);
+    Reserved::colorToTween(frameColor, values);
+    return true;
+}
+
+void GUILib::Frame::setTweenValue(TweenType type, const double* values)
+{
+    if (type != TweenType::COLOR) {
+        GuiObject::setTweenValue(type, values);
+        return;
+    }
+    setFrameColor(Reserved::tweenToColor(values));
+}
+
 GUILib::Frame& GUILib::Frame::operator=(Frame&& other) noexcept
 {
     if (&other == this) return *this;
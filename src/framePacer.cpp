@@ -0,0 +1,36 @@
+#include "framePacer.h"
+
+#include <thread>
+
+using namespace GUILib::Reserved;
+
+FramePacer::FramePacer(Clock::duration interval, Clock::duration spinMargin) :
+    interval(interval),
+    spinMargin(spinMargin)
+{
+    reset();
+}
+
+void FramePacer::reset()
+{
+    deadline = Clock::now() + interval;
+}
+
+void FramePacer::wait()
+{
+    if (interval <= Clock::duration::zero()) return;
+
+    Clock::time_point now = Clock::now();
+    // Too late to catch up, the next frames are counted from this one
+    if (now >= deadline + interval) {
+        deadline = now + interval;
+        return;
+    }
+
+    if (deadline - now > spinMargin)
+        std::this_thread::sleep_for(deadline - now - spinMargin);
+    while ((now = Clock::now()) < deadline)
+        std::this_thread::yield();
+
+    deadline += interval;
+}
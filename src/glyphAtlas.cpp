@@ -0,0 +1,283 @@
+#include "glyphAtlas.h"
+#include "renderList.h"
+
+using namespace GUILib::Reserved;
+
+namespace {
+    std::unordered_map<TTF_Font*, std::unique_ptr<FontMetrics>>& fontMetrics()
+    {
+        static std::unordered_map<TTF_Font*, std::unique_ptr<FontMetrics>> metrics;
+        return metrics;
+    }
+
+    std::map<std::pair<SDL_Renderer*, TTF_Font*>, std::unique_ptr<GlyphAtlas>>& glyphAtlases()
+    {
+        static std::map<std::pair<SDL_Renderer*, TTF_Font*>, std::unique_ptr<GlyphAtlas>> atlases;
+        return atlases;
+    }
+
+    constexpr Uint32 REPLACEMENT_CHARACTER = 0xFFFD;
+}
+
+const std::vector<int>& GUILib::Reserved::quadIndices(size_t quadCount)
+{
+    static std::vector<int> indices;
+    for (size_t quad = indices.size() / 6; quad < quadCount; ++quad) {
+        const int base = static_cast<int>(quad * 4);
+        indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+    }
+    return indices;
+}
+
+Uint32 GUILib::Reserved::decodeUtf8(std::string_view str, size_t& index)
+{
+    const auto lead = static_cast<unsigned char>(str[index++]);
+    if (lead < 0x80) return lead;
+
+    int length = 0;
+    Uint32 codepoint = 0;
+    if ((lead & 0xE0) == 0xC0) { length = 1; codepoint = lead & 0x1F; }
+    else if ((lead & 0xF0) == 0xE0) { length = 2; codepoint = lead & 0x0F; }
+    else if ((lead & 0xF8) == 0xF0) { length = 3; codepoint = lead & 0x07; }
+    else return REPLACEMENT_CHARACTER;
+
+    if (index + length > str.size()) return REPLACEMENT_CHARACTER;
+    for (int i = 0; i < length; ++i) {
+        const auto next = static_cast<unsigned char>(str[index + i]);
+        if ((next & 0xC0) != 0x80) return REPLACEMENT_CHARACTER;
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    index += length;
+    return codepoint;
+}
+
+FontMetrics::FontMetrics(TTF_Font* font) :
+    font(font),
+    kerningEnabled(font && TTF_GetFontKerning(font) != 0),
+    fontHeight(font ? TTF_FontHeight(font) : 0)
+{
+    std::fill(std::begin(asciiAdvances), std::end(asciiAdvances), -1);
+}
+
+FontMetrics& FontMetrics::get(TTF_Font* font)
+{
+    auto& metrics = fontMetrics()[font];
+    if (!metrics) metrics = std::make_unique<FontMetrics>(font);
+    return *metrics;
+}
+
+void FontMetrics::releaseFont(TTF_Font* font)
+{
+    fontMetrics().erase(font);
+    GlyphAtlas::releaseFont(font);
+}
+
+int FontMetrics::advance(Uint32 codepoint)
+{
+    if (codepoint < 128 && asciiAdvances[codepoint] >= 0) return asciiAdvances[codepoint];
+    if (codepoint >= 128) {
+        if (const auto it = advances.find(codepoint); it != advances.end()) return it->second;
+    }
+
+    int value = 0;
+    if (!font || TTF_GlyphMetrics32(font, codepoint, nullptr, nullptr, nullptr, nullptr, &value) != 0) {
+        value = 0;
+    }
+
+    if (codepoint < 128) asciiAdvances[codepoint] = value;
+    else advances[codepoint] = value;
+    return value;
+}
+
+int FontMetrics::kerning(Uint32 previous, Uint32 codepoint)
+{
+    if (!kerningEnabled || previous == 0) return 0;
+
+    const std::uint64_t key = static_cast<std::uint64_t>(previous) << 32 | codepoint;
+    if (const auto it = kernings.find(key); it != kernings.end()) return it->second;
+
+    const int value = TTF_GetFontKerningSizeGlyphs32(font, previous, codepoint);
+    kernings[key] = value;
+    return value;
+}
+
+int FontMetrics::measure(std::string_view str)
+{
+    int width = 0;
+    Uint32 previous = 0;
+    for (size_t i = 0; i < str.size();) {
+        const Uint32 codepoint = decodeUtf8(str, i);
+        width += kerning(previous, codepoint) + advance(codepoint);
+        previous = codepoint;
+    }
+    return width;
+}
+
+int FontMetrics::height() const
+{
+    return fontHeight;
+}
+
+GlyphAtlas::GlyphAtlas(SDL_Renderer* r, TTF_Font* font) : renderer(r), font(font)
+{
+    static std::uint64_t nextId = 1;
+    id = nextId++;
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    for (SDL_Texture* texture : pages) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+GlyphAtlas& GlyphAtlas::get(SDL_Renderer* r, TTF_Font* font)
+{
+    auto& atlas = glyphAtlases()[{ r, font }];
+    if (!atlas) atlas = std::make_unique<GlyphAtlas>(r, font);
+    return *atlas;
+}
+
+void GlyphAtlas::releaseRenderer(SDL_Renderer* r)
+{
+    auto& atlases = glyphAtlases();
+    for (auto it = atlases.begin(); it != atlases.end();) {
+        if (it->first.first == r) it = atlases.erase(it);
+        else ++it;
+    }
+}
+
+void GlyphAtlas::releaseFont(TTF_Font* font)
+{
+    auto& atlases = glyphAtlases();
+    for (auto it = atlases.begin(); it != atlases.end();) {
+        if (it->first.second == font) it = atlases.erase(it);
+        else ++it;
+    }
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::glyph(Uint32 codepoint)
+{
+    if (codepoint < 128) {
+        if (!asciiLoaded[codepoint]) {
+            asciiGlyphs[codepoint] = load(codepoint);
+            asciiLoaded[codepoint] = true;
+        }
+        return asciiGlyphs[codepoint];
+    }
+
+    if (const auto it = glyphs.find(codepoint); it != glyphs.end()) return it->second;
+    return glyphs[codepoint] = load(codepoint);
+}
+
+SDL_Texture* GlyphAtlas::page(int index) const
+{
+    return pages[index];
+}
+
+size_t GlyphAtlas::pageCount() const
+{
+    return pages.size();
+}
+
+std::uint64_t GlyphAtlas::getId() const
+{
+    return id;
+}
+
+GlyphAtlas::Glyph GlyphAtlas::load(Uint32 codepoint)
+{
+    Glyph result;
+    // Control characters have nothing to draw
+    if (!font || codepoint < 0x20) return result;
+
+    int minX = 0, maxX = 0, advance = 0;
+    if (TTF_GlyphMetrics32(font, codepoint, &minX, &maxX, nullptr, nullptr, &advance) != 0 || maxX <= minX) {
+        return result; // Blank glyph, spaces and such
+    }
+
+    SDL_Surface* rendered = TTF_RenderGlyph32_Blended(font, codepoint, { 255, 255, 255, 255 });
+    if (!rendered) return result;
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(rendered);
+    if (!surface) return result;
+
+    int pageIndex = -1;
+    SDL_Point position {};
+    if (allocate(surface->w, surface->h, pageIndex, position)) {
+        const SDL_Rect area = { position.x, position.y, surface->w, surface->h };
+        SDL_UpdateTexture(pages[pageIndex], &area, surface->pixels, surface->pitch);
+
+        result.page = pageIndex;
+        result.source = area;
+        // Glyphs overhanging to the left are rendered shifted right by the overhang
+        result.offsetX = std::min(0, minX);
+    }
+    SDL_FreeSurface(surface);
+    return result;
+}
+
+bool GlyphAtlas::allocate(int w, int h, int& page, SDL_Point& position)
+{
+    // Keeps filtered samples from bleeding into the neighbours
+    constexpr int padding = 1;
+    if (w + padding > PAGE_SIZE || h + padding > PAGE_SIZE) return false;
+
+    if (shelfX + w + padding > PAGE_SIZE) {
+        shelfY += shelfHeight;
+        shelfX = 0;
+        shelfHeight = 0;
+    }
+
+    if (pages.empty() || shelfY + h + padding > PAGE_SIZE) {
+        SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, PAGE_SIZE, PAGE_SIZE);
+        if (!texture) return false;
+
+        const std::vector<Uint32> transparent(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE, 0);
+        SDL_UpdateTexture(texture, nullptr, transparent.data(), PAGE_SIZE * static_cast<int>(sizeof(Uint32)));
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+        pages.push_back(texture);
+        shelfX = shelfY = shelfHeight = 0;
+    }
+
+    page = static_cast<int>(pages.size()) - 1;
+    position = { shelfX, shelfY };
+
+    shelfX += w + padding;
+    shelfHeight = std::max(shelfHeight, h + padding);
+    return true;
+}
+
+void GlyphAtlas::draw(const std::vector<std::vector<SDL_Vertex>>& quads) const
+{
+    auto& renderList = RenderList::get(renderer);
+    for (size_t i = 0; i < quads.size() && i < pages.size(); ++i) {
+        renderList.quads(pages[i], quads[i]);
+    }
+}
+
+void GUILib::Reserved::appendGlyphQuad(
+    std::vector<std::vector<SDL_Vertex>>& quads,
+    const GlyphAtlas& atlas,
+    const GlyphAtlas::Glyph& glyph,
+    float x, float y,
+    const SDL_Color& color
+) {
+    if (glyph.page < 0) return;
+    if (quads.size() < atlas.pageCount()) quads.resize(atlas.pageCount());
+
+    constexpr float scale = 1.0f / GlyphAtlas::PAGE_SIZE;
+    const SDL_Rect& src = glyph.source;
+
+    const float left = x + glyph.offsetX, top = y;
+    const float right = left + src.w, bottom = top + src.h;
+    const float u0 = src.x * scale, v0 = src.y * scale;
+    const float u1 = (src.x + src.w) * scale, v1 = (src.y + src.h) * scale;
+
+    auto& vertices = quads[glyph.page];
+    vertices.push_back({ { left, top }, color, { u0, v0 } });
+    vertices.push_back({ { right, top }, color, { u1, v0 } });
+    vertices.push_back({ { right, bottom }, color, { u1, v1 } });
+    vertices.push_back({ { left, bottom }, color, { u0, v1 } });
+}
@@ -1,6 +1,10 @@
 #include "guiobject.h"
 #include "frame.h"
 #include "button.h"
+#include "damageTracker.h"
+#include "renderList.h"
+#include "layoutStore.h"
+#include "spatialIndex.h"
 
 SDL_Renderer* nullrnd = nullptr;
 
@@ -10,117 +14,165 @@ static std::ostream& operator<<(std::ostream& os, const GUILib::UIUnit& u)
 	return os;
 }
 
-/// Recursive calculation
-static std::pair<GUILib::UIUnit, GUILib::UIUnit> calculateChild(
-	const GUILib::GuiObject& obj,
-	const int& windowWidth,
-	const int& windowHeight
-) {
-	// Base case: If no parent exists, calculate relative to the window
-	const auto [objSize, objPos] = std::pair { obj.getSize(), obj.getPosition() };
-	GUILib::UIUnit outPos{}, outSize{};
-
-	if (!obj.hasParent()) {
-
-		outSize.sizeX = static_cast<int>(
-			objSize.isUsingScale ? windowWidth * objSize.sizeX : objSize.sizeX);
-		outSize.sizeY = static_cast<int>(
-			objSize.isUsingScale ? windowHeight * objSize.sizeY : objSize.sizeY);
-
-		outPos.sizeX = static_cast<int>(
-			objPos.isUsingScale ? windowWidth * objPos.sizeX : objPos.sizeX);
-		outPos.sizeY = static_cast<int>(
-			objPos.isUsingScale ? windowHeight * objPos.sizeY : objPos.sizeY);
-
-		outPos.isUsingScale = objPos.isUsingScale;
-		outSize.isUsingScale = objSize.isUsingScale;
-
-		return { outPos, outSize };
-	}
-
-	// Recursive case: Calculate parent's position and size first
-	const auto& parent = obj.getParent(); // Will never be a dangling pointer
-	auto [parentPos, parentSize] = calculateChild(*parent.lock(), windowWidth, windowHeight);
-
-	// Calculate this object's position and size relative to the parent's
-	outPos = {
-		parentPos.sizeX +
-		(objPos.isUsingScale ? parentSize.sizeX * objPos.sizeX : objPos.sizeX),
-		parentPos.sizeY +
-		(objPos.isUsingScale ? parentSize.sizeY * objPos.sizeY : objPos.sizeY),
-		objPos.isUsingScale
-	};
-	outSize = {
-		objSize.isUsingScale ? parentSize.sizeX * objSize.sizeX : objSize.sizeX,
-		objSize.isUsingScale ? parentSize.sizeY * objSize.sizeY : objSize.sizeY,
-		objSize.isUsingScale
-	};
-
-	if (const auto scrollingParent = parent.lock()) {
-		if (const auto sp = std::dynamic_pointer_cast<GUILib::ScrollingFrame>(scrollingParent)) {
-        	outPos.sizeX -= sp->getScrollX();
-			outPos.sizeY -= sp->getScrollY();
-		}
-    }
-
-	return { outPos, outSize };
-}
-
 void GUILib::GuiObject::update(SDL_Renderer* renderer)
 {
 	if (!renderer)
 		return;
 
-	int ws = 0, hs = 0;
-	SDL_GetRendererOutputSize(renderer, &ws, &hs);
+	// A scene manager rendering with this renderer has handed the output size to its roots already
+	if (!hasParent() && renderer != sceneRenderer)
+		refreshOutputSize();
+
+	resolveLayout();
+}
 
-	auto [calculatedPos, calculatedSize] = calculateChild(*this, ws, hs);
+bool GUILib::GuiObject::refreshOutputSize()
+{
+	if (!ref) return false;
 
-	objRect.x = static_cast<int>(calculatedPos.sizeX);
-	objRect.y = static_cast<int>(calculatedPos.sizeY);
-	objRect.w = static_cast<int>(calculatedSize.sizeX);
-	objRect.h = static_cast<int>(calculatedSize.sizeY);
+	SDL_Point outputSize {};
+	SDL_GetRendererOutputSize(ref, &outputSize.x, &outputSize.y);
+	return setOutputSize(outputSize);
 }
 
-void GUILib::GuiObject::move(const UIUnit& newPos)
+bool GUILib::GuiObject::setOutputSize(const SDL_Point& outputSize)
 {
-	position = newPos;
-	int ws = 0, hs = 0;
-	SDL_GetRendererOutputSize(ref, &ws, &hs);
-	if (parent.lock()) {
-		SDL_Rect parentSize = parent.lock()->getRect();
-		objRect.x = static_cast<int>(position.isUsingScale ? parentSize.w * position.sizeX : position.sizeX);
-		objRect.y = static_cast<int>(position.isUsingScale ? parentSize.h * position.sizeY : position.sizeY);
+	if (hasParent() || !Reserved::LayoutStore::get().setOutputSize(node, outputSize)) return false;
+	invalidateLayout();
+	return true;
+}
+
+void GUILib::GuiObject::resolveLayouts(const std::vector<Reserved::NodeHandle>& roots)
+{
+	if (Reserved::LayoutStore::get().resolveDirty(roots) > 0)
+		treeRevision++;
+}
+
+void GUILib::GuiObject::invalidateLayout()
+{
+	auto& store = Reserved::LayoutStore::get();
+	if (store.markDirty(node)) {
+		// Descendants of a dirty object are always dirty, so already dirty subtrees can be skipped
+		invalidateChildrenLayout();
 	}
-	else {
-		objRect.x = static_cast<int>(position.isUsingScale ? position.sizeX * ws : position.sizeX);
-		objRect.y = static_cast<int>(position.isUsingScale ? position.sizeY * hs : position.sizeY);
+
+	// Let the ancestors know that the layout pass has to come down here
+	store.markAncestors(node);
+}
+
+void GUILib::GuiObject::invalidateChildrenLayout()
+{
+	auto& store = Reserved::LayoutStore::get();
+	store.setContentOffset(node, getContentOffset());
+	store.markChildrenDirty(node);
+}
+
+void GUILib::GuiObject::invalidateContentOffset()
+{
+	Reserved::LayoutStore::get().setContentOffset(node, getContentOffset());
+}
+
+void GUILib::GuiObject::resolveLayout() const
+{
+	if (Reserved::LayoutStore::get().resolve(node))
+		treeRevision++;
+}
+
+void GUILib::GuiObject::applyLayout(const SDL_Rect& previous, const SDL_Rect& current) const
+{
+	objRect = current;
+
+	// Both the area left and the one taken have to be drawn again
+	damageArea(previous);
+	damageArea(objRect);
+	// A cached texture of another size is drawn anew anyway
+	invalidateCache(false);
+	// The hit-test grids move it to other cells, rather than being rebuilt
+	Reserved::SpatialIndex::objectMoved(this, objRect);
+}
+
+void GUILib::GuiObject::updateLayout()
+{
+	// After a resize the whole tree is out of date, it's laid out a level at a time instead of object by object.
+	// The whole output is drawn again, which spares tracking the area of every object
+	if (!hasParent() && ref != sceneRenderer && refreshOutputSize()) {
+		Reserved::DamageTracker::get(ref).addAll();
+		resolveLayouts({ node });
 	}
 
-	update(ref);
-	trigger("onPositionChange", position);
+	resolveLayout();
+
+	if (!Reserved::LayoutStore::get().clearDescendantsDirty(node)) return;
+
+	updateChildrenLayout();
+}
+
+void GUILib::GuiObject::updateChildrenLayout()
+{
+	const auto& store = Reserved::LayoutStore::get();
+	for (const auto& child : children) {
+		if (!child) continue;
+		if (store.needsLayout(child->node))
+			child->updateLayout();
+	}
+}
+
+SDL_Rect GUILib::GuiObject::getContentRect(const GuiObject& obj)
+{
+	return Reserved::LayoutStore::get().getContentRect(obj.node);
+}
+
+SDL_Point GUILib::GuiObject::getContentOffset() const
+{
+	return { 0, 0 };
+}
+
+void GUILib::GuiObject::notifyParentGeometry() const
+{
+	// Read from the store, which spares locking the parent on every move
+	const auto& store = Reserved::LayoutStore::get();
+	if (const Reserved::NodeHandle p = store.getParent(node); p != Reserved::INVALID_NODE)
+		store.getOwner(p)->childrenGeometryRevision++;
+}
+
+void GUILib::GuiObject::invalidateTree() const
+{
+	treeRevision++;
+	Reserved::SpatialIndex::objectChanged(this);
+}
+
+void GUILib::GuiObject::move(const UIUnit& newPos)
+{
+	Reserved::LayoutStore::get().setPosition(node, newPos.sizeX, newPos.sizeY, newPos.isUsingScale);
+	invalidateLayout();
+	notifyParentGeometry();
+	onPositionChange.fire(newPos);
 }
 
 void GUILib::GuiObject::resize(const UIUnit& newSize)
 {
-	size = newSize;
-	update(ref);
-	trigger("onSizeChange", size);
+	Reserved::LayoutStore::get().setSize(node, newSize.sizeX, newSize.sizeY, newSize.isUsingScale);
+	invalidateLayout();
+	notifyParentGeometry();
+	onSizeChange.fire(newSize);
 }
 
 SDL_Rect GUILib::GuiObject::getRect() const
 {
+	resolveLayout();
 	return objRect;
 }
 
 GUILib::UIUnit GUILib::GuiObject::getSize() const
 {
-	return size;
+	const auto& store = Reserved::LayoutStore::get();
+	return { store.getSizeX(node), store.getSizeY(node), store.isSizeScaled(node) };
 }
 
 GUILib::UIUnit GUILib::GuiObject::getPosition() const
 {
-	return position;
+	const auto& store = Reserved::LayoutStore::get();
+	return { store.getPositionX(node), store.getPositionY(node), store.isPositionScaled(node) };
 }
 
 void GUILib::GuiObject::handleEvent(const SDL_Event& event)
@@ -129,29 +181,44 @@ void GUILib::GuiObject::handleEvent(const SDL_Event& event)
 		return;
 	}
 	children.erase(std::remove_if(children.begin(), children.end(), [](const auto& ptr) { return ptr.get() == nullptr; }), children.end());
+
+	// Keystrokes belong to a single object, passing them down would have every text box of the tree type them
+	switch (event.type) {
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+	case SDL_TEXTINPUT:
+	case SDL_TEXTEDITING:
+		processEvent(event);
+		return;
+	default: break;
+	}
+
 	for (const auto& child : children) {
 		if (!child) continue;
 		child->handleEvent(event);
 	}
 
-	if (!isDraggable()) return;
+	processEvent(event);
+}
 
-	int ws = 0, hs = 0;
-	SDL_GetRendererOutputSize(ref, &ws, &hs);
+void GUILib::GuiObject::processEvent(const SDL_Event& event)
+{
+	if (!isDraggable()) return;
 
-	
 	switch (event.type) {
 	case SDL_MOUSEBUTTONDOWN:
-		if (event.button.button == SDL_BUTTON_LEFT &&
-			event.button.x >= objRect.x &&
-			event.button.x <= objRect.x + objRect.w &&
-			event.button.y >= objRect.y &&
-			event.button.y <= objRect.y + objRect.h
+		// Only a press needs the rect, motions keep moving the object without laying it out in between
+		if (const SDL_Rect rect = getRect();
+			event.button.button == SDL_BUTTON_LEFT &&
+			event.button.x >= rect.x &&
+			event.button.x <= rect.x + rect.w &&
+			event.button.y >= rect.y &&
+			event.button.y <= rect.y + rect.h
 			) {
 			isDragging = true;
-			dragOffsetX = event.button.x - objRect.x;
-			dragOffsetY = event.button.y - objRect.y;
-			trigger("onDragging", event.button.x, event.button.y);
+			dragOffsetX = event.button.x - rect.x;
+			dragOffsetY = event.button.y - rect.y;
+			onDragging.fire(event.button.x, event.button.y);
 		}
 		break;
 
@@ -167,10 +234,16 @@ void GUILib::GuiObject::handleEvent(const SDL_Event& event)
 		const int offsetX = event.motion.x - dragOffsetX;
 		const int offsetY = event.motion.y - dragOffsetY;
 
+		const auto& store = Reserved::LayoutStore::get();
+		const bool scaled = store.isPositionScaled(node);
+		// The size the root was last laid out against, queried only if it never was
+		SDL_Point output = store.getOutputSize(store.getRoot(node));
+		if (scaled && (output.x == 0 || output.y == 0)) SDL_GetRendererOutputSize(ref, &output.x, &output.y);
+
 		const UIUnit newPos {
-			position.isUsingScale ? static_cast<double>(offsetX) / static_cast<double>(ws) : offsetX,
-			position.isUsingScale ? static_cast<double>(offsetY) / static_cast<double>(hs) : offsetY,
-			position.isUsingScale
+			scaled ? static_cast<double>(offsetX) / static_cast<double>(output.x) : offsetX,
+			scaled ? static_cast<double>(offsetY) / static_cast<double>(output.y) : offsetY,
+			scaled
 		};
 
 		move(newPos);
@@ -179,9 +252,8 @@ void GUILib::GuiObject::handleEvent(const SDL_Event& event)
 }
 
 GUILib::GuiObject::GuiObject():
-	size(UIUnit()),
-	position(UIUnit()),
 	objRect{ 0, 0, 0, 0 },
+	node(Reserved::LayoutStore::get().create(this)),
 	visible(false),
 	active(false),
 	ref(nullrnd),
@@ -189,9 +261,8 @@ GUILib::GuiObject::GuiObject():
 	isDragging(false),
 	dragOffsetX(0),
 	dragOffsetY(0),
-	shouldRenderChildren(true),
-	renderingPivotOffset(),
-	degreeRotation()
+	childrenGeometryRevision(0),
+	shouldRenderChildren(true)
 {}
 GUILib::GuiObject::GuiObject(
 	std::shared_ptr<GuiObject> parent,
@@ -200,9 +271,8 @@ GUILib::GuiObject::GuiObject(
 	UIUnit position,
 	bool isVisible, bool isActive
 ) :
-	position(position),
-	size(size),
 	objRect({ 0, 0, 0, 0 }),
+	node(Reserved::LayoutStore::get().create(this)),
 	visible(isVisible),
 	active(isActive),
 	parent(parent),
@@ -211,10 +281,14 @@ GUILib::GuiObject::GuiObject(
 	isDragging(false),
 	dragOffsetX(0),
 	dragOffsetY(0),
-	shouldRenderChildren(true),
-	renderingPivotOffset(),
-	degreeRotation()
+	childrenGeometryRevision(0),
+	shouldRenderChildren(true)
 {
+	auto& store = Reserved::LayoutStore::get();
+	store.setPosition(node, position.sizeX, position.sizeY, position.isUsingScale);
+	store.setSize(node, size.sizeX, size.sizeY, size.isUsingScale);
+	if (parent) store.setParent(node, parent->node);
+
 	if (renderer)
 		update(renderer);
 	if (parent) {
@@ -237,11 +311,12 @@ GUILib::GuiObject& GUILib::GuiObject::operator=(const GUILib::GuiObject& other)
 	if (this == &other) return *this;
 	ref = other.ref;
 
-	size = other.size;
-	position = other.position;
+	// Takes the placement and the parent, keeping the slot
+	Reserved::LayoutStore::get().copy(other.node, node);
 
 	parent = other.parent;
 	children = other.children;
+	childrenGeometryRevision++;
 
 	canBeDragged = other.canBeDragged;
 	dragOffsetX = other.dragOffsetX;
@@ -251,13 +326,13 @@ GUILib::GuiObject& GUILib::GuiObject::operator=(const GUILib::GuiObject& other)
 	visible = other.visible;
 	active = other.active;
 
-	objRect = other.objRect;
-
 	shouldRenderChildren = other.shouldRenderChildren;
-	renderingPivotOffset = other.renderingPivotOffset;
-	degreeRotation = other.degreeRotation;
 
-	update(ref);
+	cacheAsBitmap = other.cacheAsBitmap;
+	cacheTexture.reset();
+	cacheDirty = true;
+
+	invalidateLayout();
 
 	return *this;
 }
@@ -276,31 +351,44 @@ void GUILib::GuiObject::updateRenderer(SDL_Renderer* renderer)
 		child->updateRenderer(renderer);
 	}
 
-	update(renderer);
-    trigger("onRendererUpdate");
+	Reserved::LayoutStore::get().setOutputSize(node, { 0, 0 });
+	invalidateLayout();
+    onRendererUpdate.fire();
 }
 
 GUILib::GuiObject::~GuiObject()
 {
-	
+	Reserved::LayoutStore::get().destroy(node);
 }
 
 void GUILib::GuiObject::setVisible(bool value)
 {
+    if (visible != value) {
+        invalidateTree();
+        damageSubtree();
+    }
     visible = value;
-    trigger("onVisibilityChange");
+    onVisibilityChange.fire();
 }
 
 void GUILib::GuiObject::toggleVisibility(bool value)
 {
+	if (visible != value) {
+		invalidateTree();
+		damageSubtree();
+	}
 	visible = value;
-	trigger("onVisibilityChange");
+	onVisibilityChange.fire();
 }
 
 void GUILib::GuiObject::setActive(bool value)
 { 
+	if (active != value) {
+		invalidateTree();
+		damageSubtree();
+	}
 	active = value;
-	trigger("onActiveChange");
+	onActiveChange.fire();
 }
 
 const std::weak_ptr<GUILib::GuiObject>& GUILib::GuiObject::getParent() const
@@ -327,21 +415,31 @@ bool GUILib::GuiObject::setParent(const std::shared_ptr<GuiObject>& newParent)
         throw std::logic_error("Cannot set a descendant as parent (what the fuck are you doing?)");
     }
 
+    // Where the subtree was drawn, the new place is marked once laid out
+    damageSubtree();
+
     // Detach from current parent
     if (auto oldParent = parent.lock()) {
         auto& siblings = oldParent->children;
 		siblings.erase(std::remove(siblings.begin(), siblings.end(), self), siblings.end());
+		oldParent->childrenGeometryRevision++;
     }
 
     parent = newParent;
+	Reserved::LayoutStore::get().setParent(node, newParent ? newParent->node : Reserved::INVALID_NODE);
 	success = true;
 
     // Attach to new parent
     if (newParent) {
         newParent->children.push_back(self);
+		newParent->childrenGeometryRevision++;
     }
 
-    trigger("onParentChange", success);
+	// The whole subtree is now relative to another object
+	invalidateLayout();
+	invalidateTree();
+
+    onParentChange.fire(success);
 	return success;
 }
 
@@ -360,7 +458,7 @@ bool GUILib::GuiObject::addChild(const std::shared_ptr<GuiObject>& child)
 		child->setParent(shared_from_this());
 		success = true;
 	}
-	trigger("onChildAdded", success);
+	onChildAdded.fire(success);
 	return success;
 }
 
@@ -373,7 +471,7 @@ bool GUILib::GuiObject::removeChild(const std::shared_ptr<GuiObject>& child)
 	if (child->parent.lock().get() == this) {
 		success = child->setParent(nullptr);
 	}
-	trigger("onChildRemoved", success);
+	onChildRemoved.fire(success);
 	return success;
 }
 
@@ -407,14 +505,126 @@ void GUILib::GuiObject::setDraggable(bool value)
 
 void GUILib::GuiObject::render()
 {
-	update(ref);
+	resolveLayout();
 	if (!shouldRender()) return;
 	if (!shouldRenderChildren) return;
 
     for (const auto& child : children) {
 		if (!child) continue;
 		child->updateRenderer(ref);
-		child->render();
+		child->draw();
+	}
+}
+
+void GUILib::GuiObject::draw()
+{
+	if (!cacheAsBitmap || !ref) {
+		render();
+		return;
+	}
+
+	update(ref);
+	if (!shouldRender()) return;
+
+	if (!refreshCache()) {
+		render();
+		return;
+	}
+
+	const SDL_Point pivot = getPivotOffsetPoint();
+	Reserved::RenderList::get(ref).copy(cacheTexture.get(), { 0, 0, objRect.w, objRect.h }, objRect, getRotation(), &pivot);
+}
+
+bool GUILib::GuiObject::refreshCache()
+{
+	if (objRect.w <= 0 || objRect.h <= 0 || !SDL_RenderTargetSupported(ref)) return false;
+
+	int w = 0, h = 0;
+	if (cacheTexture) SDL_QueryTexture(cacheTexture.get(), nullptr, nullptr, &w, &h);
+	// Copies of the object share the texture until one of them draws again
+	const bool reusable = cacheTexture.use_count() == 1 && w == objRect.w && h == objRect.h && cachedGeneration == cacheGeneration;
+	if (reusable && !cacheDirty) return true;
+
+	if (!reusable) {
+		cacheTexture.reset();
+		SDL_Texture* created = SDL_CreateTexture(ref, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, objRect.w, objRect.h);
+		if (!created) return false;
+
+		// The subtree is blended over transparent pixels, which leaves their colors multiplied by their alpha
+		const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+		if (SDL_SetTextureBlendMode(created, premultiplied) != 0) SDL_SetTextureBlendMode(created, SDL_BLENDMODE_BLEND);
+
+		cacheTexture = std::shared_ptr<SDL_Texture>(created, SDL_DestroyTexture);
+		cachedGeneration = cacheGeneration;
+	}
+	// Changes made while drawing show up the next time
+	cacheDirty = false;
+
+	auto& renderList = Reserved::RenderList::get(ref);
+	renderList.pushLayer();
+
+	// Drawn upright, the rotation applies to the texture
+	auto& store = Reserved::LayoutStore::get();
+	const double rotation = store.getRotation(node);
+	store.setRotation(node, 0.0);
+	render();
+	store.setRotation(node, rotation);
+
+	renderList.end();
+	renderList.translate(-objRect.x, -objRect.y);
+
+	SDL_Texture* previousTarget = SDL_GetRenderTarget(ref);
+	SDL_BlendMode previousMode = SDL_BLENDMODE_NONE;
+	SDL_GetRenderDrawBlendMode(ref, &previousMode);
+	Uint8 r = 0, g = 0, b = 0, a = 0;
+	SDL_GetRenderDrawColor(ref, &r, &g, &b, &a);
+
+	SDL_SetRenderTarget(ref, cacheTexture.get());
+	SDL_SetRenderDrawColor(ref, 0, 0, 0, 0);
+	SDL_RenderClear(ref);
+	renderList.submit();
+	SDL_SetRenderTarget(ref, previousTarget);
+
+	SDL_SetRenderDrawColor(ref, r, g, b, a);
+	SDL_SetRenderDrawBlendMode(ref, previousMode);
+
+	renderList.popLayer();
+	return true;
+}
+
+void GUILib::GuiObject::setCacheAsBitmap(bool value)
+{
+	if (cacheAsBitmap == value) return;
+	cacheAsBitmap = value;
+	anyCache = anyCache || value;
+	cacheDirty = true;
+	if (!value) cacheTexture.reset();
+	invalidateRender();
+}
+
+bool GUILib::GuiObject::isCachedAsBitmap() const
+{
+	return cacheAsBitmap;
+}
+
+void GUILib::GuiObject::invalidateCaches()
+{
+	cacheGeneration++;
+	renderRevision++;
+}
+
+void GUILib::GuiObject::invalidateCache(bool includeSelf) const
+{
+	if (!anyCache) return;
+
+	if (includeSelf && cacheAsBitmap) cacheDirty = true;
+	for (auto p = parent.lock(); p; p = p->parent.lock()) {
+		if (!p->cacheAsBitmap) continue;
+		p->cacheDirty = true;
+		// Drawn turned with the texture, the area of the descendant may not be where it shows
+		p->damageArea(p->objRect);
 	}
 }
 
@@ -435,9 +645,124 @@ bool GUILib::GuiObject::getChildrenRenderingState() const
 
 void GUILib::GuiObject::setChildrenRenderingState(bool value)
 {
+	if (shouldRenderChildren != value) {
+		invalidateTree();
+		for (const auto& child : children) {
+			if (child) child->damageSubtree();
+		}
+	}
 	shouldRenderChildren = value;
 }
 
+bool GUILib::GuiObject::isFocusable() const
+{
+	return false;
+}
+
+bool GUILib::GuiObject::acceptsTextInput() const
+{
+	return false;
+}
+
+void GUILib::GuiObject::focusChanged(bool)
+{
+}
+
+bool GUILib::GuiObject::handlesTab() const
+{
+	return false;
+}
+
+bool GUILib::GuiObject::needsEveryMotion() const
+{
+	return false;
+}
+
+bool GUILib::GuiObject::clipsChildren() const
+{
+	return false;
+}
+
+void GUILib::GuiObject::forEachChildInView(const std::function<void(GuiObject*)>& callback)
+{
+	for (const auto& child : children) {
+		callback(child.get());
+	}
+}
+
+const std::vector<std::shared_ptr<GUILib::GuiObject>>& GUILib::GuiObject::getChildren() const
+{
+	return children;
+}
+
+std::uint64_t GUILib::GuiObject::getTreeRevision()
+{
+	return treeRevision;
+}
+
+std::uint64_t GUILib::GuiObject::getRenderRevision()
+{
+	if (renderDeadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= renderDeadline) {
+		renderDeadline = std::chrono::steady_clock::time_point::max();
+		renderRevision++;
+	}
+	return treeRevision + renderRevision;
+}
+
+void GUILib::GuiObject::invalidateRender()
+{
+	damage();
+	renderRevision++;
+}
+
+void GUILib::GuiObject::damage() const
+{
+	damageArea(objRect);
+	invalidateCache(true);
+}
+
+void GUILib::GuiObject::damageArea(const SDL_Rect& area) const
+{
+	if (!ref || area.w <= 0 || area.h <= 0) return;
+
+	const double rotation = getRotation();
+	if (std::fmod(rotation, 360.0) == 0.0) {
+		Reserved::DamageTracker::get(ref).add(area);
+		return;
+	}
+
+	// The bounding box of the corners turned around the pivot
+	const SDL_Point pivot = getPivotOffset().getAbsoluteSize({ area.w, area.h });
+	const double pivotX = area.x + pivot.x, pivotY = area.y + pivot.y;
+	const double radians = rotation * 3.14159265358979323846 / 180.0;
+	const double c = std::cos(radians), s = std::sin(radians);
+
+	double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+	const SDL_Point corners[4] = { { area.x, area.y }, { area.x + area.w, area.y }, { area.x + area.w, area.y + area.h }, { area.x, area.y + area.h } };
+	for (size_t i = 0; i < 4; ++i) {
+		const double rx = corners[i].x - pivotX, ry = corners[i].y - pivotY;
+		const double x = pivotX + rx * c - ry * s, y = pivotY + rx * s + ry * c;
+		minX = i == 0 ? x : std::min(minX, x); maxX = i == 0 ? x : std::max(maxX, x);
+		minY = i == 0 ? y : std::min(minY, y); maxY = i == 0 ? y : std::max(maxY, y);
+	}
+
+	const int left = static_cast<int>(std::floor(minX)), top = static_cast<int>(std::floor(minY));
+	Reserved::DamageTracker::get(ref).add({ left, top, static_cast<int>(std::ceil(maxX)) - left, static_cast<int>(std::ceil(maxY)) - top });
+}
+
+void GUILib::GuiObject::damageSubtree() const
+{
+	damage();
+	for (const auto& child : children) {
+		if (child) child->damageSubtree();
+	}
+}
+
+void GUILib::GuiObject::invalidateRenderAt(std::chrono::steady_clock::time_point time)
+{
+	renderDeadline = std::min(renderDeadline, time);
+}
+
 SDL_Point GUILib::UIUnit::getAbsoluteSize(const SDL_Point& containerSize) const
 {
 	if (isUsingScale) {
@@ -456,6 +781,31 @@ bool GUILib::Reserved::isPointInRect(const SDL_Point& point, const SDL_Rect& rec
 		   point.y >= rect.y && point.y <= rect.y + rect.h;
 }
 
+bool GUILib::Reserved::getEventPointer(const SDL_Event& event, SDL_Point& out)
+{
+	// Wheel events only carry the pointer since SDL 2.26, before that they are where the last pointer event was
+	static SDL_Point last { -1, -1 };
+
+	switch (event.type) {
+	case SDL_MOUSEMOTION:
+		last = { event.motion.x, event.motion.y };
+		break;
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEBUTTONUP:
+		last = { event.button.x, event.button.y };
+		break;
+	case SDL_MOUSEWHEEL:
+#if SDL_VERSION_ATLEAST(2, 26, 0)
+		last = { event.wheel.mouseX, event.wheel.mouseY };
+#endif
+		break;
+	default:
+		return false;
+	}
+	out = last;
+	return true;
+}
+
 GUILib::Reserved::TextureType GUILib::Reserved::createSolidBoxTexture(
 	SDL_Renderer* r,
 	SDL_Color c,
@@ -487,29 +837,54 @@ GUILib::Reserved::TextureType GUILib::Reserved::createSolidBoxTexture(
 
 GUILib::UIUnit GUILib::GuiObject::getPivotOffset() const
 {
-	return renderingPivotOffset;
+	const auto& store = Reserved::LayoutStore::get();
+	return { store.getPivotX(node), store.getPivotY(node), store.isPivotScaled(node) };
 }
 
 SDL_Point GUILib::GuiObject::getPivotOffsetPoint() const
 {
-	return renderingPivotOffset.getAbsoluteSize({ getRect().w, getRect().h });
+	return getPivotOffset().getAbsoluteSize({ getRect().w, getRect().h });
 }
 
 void GUILib::GuiObject::setRotation(const double& rotation)
 {
-	degreeRotation = rotation;
-	trigger("onRotationChange", rotation);
+	// The areas covered at both angles. A cached texture is only drawn turned, it stays as is
+	damageArea(objRect);
+	Reserved::LayoutStore::get().setRotation(node, rotation);
+	damageArea(objRect);
+	invalidateCache(false);
+	renderRevision++;
+	onRotationChange.fire(rotation);
 }
 
 double GUILib::GuiObject::getRotation() const
 {
-	return degreeRotation;
+	return Reserved::LayoutStore::get().getRotation(node);
 }
 
 void GUILib::GuiObject::setPivotOffset(const UIUnit& offset)
 {
-	renderingPivotOffset = offset;
-	trigger("onPivotOffsetChange", offset);
+	damageArea(objRect);
+	Reserved::LayoutStore::get().setPivot(node, offset.sizeX, offset.sizeY, offset.isUsingScale);
+	damageArea(objRect);
+	invalidateCache(false);
+	renderRevision++;
+	onPivotOffsetChange.fire(offset);
+}
+
+void GUILib::Reserved::colorToTween(const SDL_Color& color, double* values)
+{
+	values[0] = color.r;
+	values[1] = color.g;
+	values[2] = color.b;
+	values[3] = color.a;
+}
+
+SDL_Color GUILib::Reserved::tweenToColor(const double* values)
+{
+	// Curves overshooting the end values would wrap around
+	const auto channel = [](double value) { return static_cast<Uint8>(std::lround(std::clamp(value, 0.0, 255.0))); };
+	return { channel(values[0]), channel(values[1]), channel(values[2]), channel(values[3]) };
 }
 
 std::pair<float, float> GUILib::Reserved::rotatePoint(float px, float py, float ox, float oy, float angle_rad)
@@ -554,13 +929,16 @@ GUILib::GuiObject& GUILib::GuiObject::operator=(GuiObject&& other) noexcept
 	ref = other.ref;
 	other.ref = nullptr;
 
-	size = other.size;
-	position = other.position;
-
-	other.size = other.position = UIUnit();
+	auto& store = Reserved::LayoutStore::get();
+	store.copy(other.node, node);
+	store.setPosition(other.node, 0.0, 0.0, false);
+	store.setSize(other.node, 0.0, 0.0, false);
+	store.setParent(other.node, Reserved::INVALID_NODE);
+	other.invalidateLayout();
 
 	parent = std::move(other.parent);
 	children = std::move(other.children);
+	childrenGeometryRevision++;
 
 	canBeDragged = other.canBeDragged;
 
@@ -576,32 +954,107 @@ GUILib::GuiObject& GUILib::GuiObject::operator=(GuiObject&& other) noexcept
 
 	other.visible = other.active = false;
 
-	objRect = other.objRect;
-	other.objRect = SDL_Rect();
-
 	shouldRenderChildren = other.shouldRenderChildren;
-	renderingPivotOffset = other.renderingPivotOffset;
-	degreeRotation = other.degreeRotation;
 
-	update(ref);
+	cacheAsBitmap = other.cacheAsBitmap;
+	cacheTexture.reset();
+	cacheDirty = true;
+
+	invalidateLayout();
 
 	return *this;
 }
 
-GUILib::GuiObject::GuiObject(GuiObject&& other) noexcept = default;
+// Written out because the slot in the layout store is never shared: a copy takes a new one,
+// and a move takes over the slot, leaving the moved-from object a new one.
+GUILib::GuiObject::GuiObject(GuiObject&& other) noexcept :
+	objRect(other.objRect),
+	node(other.node),
+	ref(other.ref),
+	parent(std::move(other.parent)),
+	dragOffsetX(other.dragOffsetX),
+	dragOffsetY(other.dragOffsetY),
+	isDragging(other.isDragging),
+	visible(other.visible),
+	active(other.active),
+	canBeDragged(other.canBeDragged),
+	events(std::move(other.events)),
+	childrenGeometryRevision(other.childrenGeometryRevision),
+	cacheAsBitmap(other.cacheAsBitmap),
+	cacheDirty(other.cacheDirty),
+	cacheTexture(std::move(other.cacheTexture)),
+	cachedGeneration(other.cachedGeneration),
+	children(std::move(other.children)),
+	shouldRenderChildren(other.shouldRenderChildren),
+	className(std::move(other.className)),
+	name(std::move(other.name)),
+	onPositionChange(std::move(other.onPositionChange)),
+	onSizeChange(std::move(other.onSizeChange)),
+	onDragging(std::move(other.onDragging)),
+	onRendererUpdate(std::move(other.onRendererUpdate)),
+	onVisibilityChange(std::move(other.onVisibilityChange)),
+	onActiveChange(std::move(other.onActiveChange)),
+	onParentChange(std::move(other.onParentChange)),
+	onChildAdded(std::move(other.onChildAdded)),
+	onChildRemoved(std::move(other.onChildRemoved)),
+	onRotationChange(std::move(other.onRotationChange)),
+	onPivotOffsetChange(std::move(other.onPivotOffsetChange)),
+	onFocusChange(std::move(other.onFocusChange))
+{
+	auto& store = Reserved::LayoutStore::get();
+	store.setOwner(node, this);
+	other.node = store.create(&other);
+	other.objRect = { 0, 0, 0, 0 };
+}
 
-GUILib::GuiObject::GuiObject(const GuiObject& other) noexcept = default;
+GUILib::GuiObject::GuiObject(const GuiObject& other) noexcept :
+	std::enable_shared_from_this<GuiObject>(),
+	objRect{ 0, 0, 0, 0 },
+	node(Reserved::LayoutStore::get().create(this)),
+	ref(other.ref),
+	parent(other.parent),
+	dragOffsetX(other.dragOffsetX),
+	dragOffsetY(other.dragOffsetY),
+	isDragging(other.isDragging),
+	visible(other.visible),
+	active(other.active),
+	canBeDragged(other.canBeDragged),
+	events(other.events),
+	childrenGeometryRevision(other.childrenGeometryRevision),
+	cacheAsBitmap(other.cacheAsBitmap),
+	cacheDirty(other.cacheDirty),
+	cacheTexture(other.cacheTexture),
+	cachedGeneration(other.cachedGeneration),
+	children(other.children),
+	shouldRenderChildren(other.shouldRenderChildren),
+	className(other.className),
+	name(other.name),
+	onPositionChange(other.onPositionChange),
+	onSizeChange(other.onSizeChange),
+	onDragging(other.onDragging),
+	onRendererUpdate(other.onRendererUpdate),
+	onVisibilityChange(other.onVisibilityChange),
+	onActiveChange(other.onActiveChange),
+	onParentChange(other.onParentChange),
+	onChildAdded(other.onChildAdded),
+	onChildRemoved(other.onChildRemoved),
+	onRotationChange(other.onRotationChange),
+	onPivotOffsetChange(other.onPivotOffsetChange),
+	onFocusChange(other.onFocusChange)
+{
+	Reserved::LayoutStore::get().copy(other.node, node);
+}
 
 std::string GUILib::GuiObject::getEssentialInformation() const {
 	std::ostringstream oss;
 	oss << "GuiObject Debug Info:\n";
 	oss << "  Name: " << name << "\n";
 	oss << "  Class: " << getClassName() << "\n";
-	oss << "  Position: " << position << "\n";
-	oss << "  Size: " << size << "\n";
+	oss << "  Position: " << getPosition() << "\n";
+	oss << "  Size: " << getSize() << "\n";
 	oss << "  Drag Offset: (" << dragOffsetX << ", " << dragOffsetY << ")\n";
-	oss << "  Rotation (deg): " << degreeRotation << "\n";
-	oss << "  Pivot Offset: " << renderingPivotOffset << "\n";
+	oss << "  Rotation (deg): " << getRotation() << "\n";
+	oss << "  Pivot Offset: " << getPivotOffset() << "\n";
 	oss << "  Active: " << (active ? "true" : "false") << "\n";
 	oss << "  Visible: " << (visible ? "true" : "false") << "\n";
 	oss << "  Is Dragging: " << (isDragging ? "true" : "false") << "\n";
@@ -628,6 +1081,48 @@ void GUILib::GuiObject::initialize(SDL_Renderer* r)
 }
 void GUILib::GuiObject::resetListeners(const std::string& eventName)
 {
+	if (auto* signal = findSignal(eventName)) signal->reset();
 	events.reset(eventName);
 }
 
+GUILib::Reserved::SignalBase* GUILib::GuiObject::findSignal(std::string_view eventName)
+{
+	if (eventName == "onPositionChange") return &onPositionChange;
+	if (eventName == "onSizeChange") return &onSizeChange;
+	if (eventName == "onDragging") return &onDragging;
+	if (eventName == "onRendererUpdate") return &onRendererUpdate;
+	if (eventName == "onVisibilityChange") return &onVisibilityChange;
+	if (eventName == "onActiveChange") return &onActiveChange;
+	if (eventName == "onParentChange") return &onParentChange;
+	if (eventName == "onChildAdded") return &onChildAdded;
+	if (eventName == "onChildRemoved") return &onChildRemoved;
+	if (eventName == "onRotationChange") return &onRotationChange;
+	if (eventName == "onPivotOffsetChange") return &onPivotOffsetChange;
+	if (eventName == "onFocusChange") return &onFocusChange;
+	return nullptr;
+}
+
+bool GUILib::GuiObject::getTweenValue(TweenType type, double* values) const
+{
+	// The alpha of an object is the one of its main color
+	if (type != TweenType::ALPHA) return false;
+
+	double color[4];
+	if (!getTweenValue(TweenType::COLOR, color) && !getTweenValue(TweenType::TEXT_COLOR, color)) return false;
+	values[0] = color[3];
+	return true;
+}
+
+void GUILib::GuiObject::setTweenValue(TweenType type, const double* values)
+{
+	if (type != TweenType::ALPHA) return;
+
+	// Every color of the object fades together
+	for (const TweenType colorType : { TweenType::COLOR, TweenType::TEXT_COLOR }) {
+		double color[4];
+		if (!getTweenValue(colorType, color)) continue;
+		color[3] = values[0];
+		setTweenValue(colorType, color);
+	}
+}
+
@@ -1,4 +1,5 @@
-#include "Image.h"
+#include "image.h"
+#include "renderList.h"
 
 #include <complex>
 
@@ -29,28 +30,76 @@ void GUILib::Image::initialize(SDL_Renderer* renderer)
 		std::cout << "The file path is empty. Set it to something before using.\n";
 	}
 
-	if (imageTexture) SDL_DestroyTexture(imageTexture);
+	imageTexture = {};
+	loadFailed = false;
+	stopWaiting();
+	invalidateRender();
 
-	const auto fPath = filePath.c_str();
-	SDL_Surface* imageSurface = IMG_Load(fPath);
-	if (imageSurface == nullptr) {
+	// Images showing the same file share the decoded texture
+	if (asyncLoading) {
+		loading = true;
+		pollTexture();
+		return;
+	}
+
+	loading = false;
+	imageTexture = Reserved::TextureCache::get(renderer).load(filePath);
+	finishLoading();
+}
+
+void GUILib::Image::pollTexture()
+{
+	// Only the images whose file came in are called back, the scene isn't recorded again until then
+	auto waiter = std::make_shared<Reserved::TextureCache::Waiter>([this] { pollTexture(); });
+	auto result = Reserved::TextureCache::get(ref).loadAsync(filePath, waiter);
+	if (!result) {
+		loadWaiter = waiter;
+		return;
+	}
+
+	loadWaiter.reset();
+	loading = false;
+	imageTexture = std::move(*result);
+	finishLoading();
+}
+
+void GUILib::Image::stopWaiting()
+{
+	if (const auto waiter = loadWaiter.lock()) *waiter = nullptr;
+	loadWaiter.reset();
+}
+
+void GUILib::Image::finishLoading()
+{
+	if (!imageTexture) {
+		loadFailed = true;
 		std::cout << "A problem occurred when trying to create image. Error: " << SDL_GetError() << '\n';
 		return;
 	}
-	imageTexture = SDL_CreateTextureFromSurface(renderer, imageSurface);
-	SDL_FreeSurface(imageSurface);
+	invalidateRender();
+	onLoaded.fire();
 }
 
 void GUILib::Image::render() {
+	update(ref);
 	if (!shouldRender()) return;
 
     SDL_RendererFlip flip = SDL_FLIP_NONE;
 
 	SDL_Point rotPivot = getPivotOffsetPoint();
 
-	if (!imageTexture) initialize(ref);
+	// The cache drops its waiters when released with the device, the file is asked for again
+	if (loading) {
+		if (loadWaiter.expired()) pollTexture();
+	}
+	else if (!imageTexture && !loadFailed) initialize(ref);
 
-    SDL_RenderCopyEx(ref, imageTexture, nullptr, &objRect, degreeRotation, &rotPivot, flip);
+	if (imageTexture) {
+		Reserved::RenderList::get(ref).copy(imageTexture.texture.get(), imageTexture.source, objRect, getRotation(), &rotPivot, flip);
+	}
+	else if (placeholderColor) {
+		Reserved::renderSolidBox(ref, *placeholderColor, objRect, getRotation(), &rotPivot);
+	}
 
 	GuiObject::render();
 }
@@ -60,37 +109,46 @@ void GUILib::Image::updatePath(const std::string& str) {
 	filePath = str;
 
 	initialize(ref);
-	trigger("onPathChange", str);
+	onPathChange.fire(str);
 }
 
-std::string GUILib::Image::getFilePath() const {
-	return filePath;
+void GUILib::Image::setPlaceholderColor(const SDL_Color& color) {
+	placeholderColor = color;
+	invalidateRender();
 }
 
-std::string GUILib::Image::previousFilePath() const {
-	return prevFilePath;
+void GUILib::Image::clearPlaceholderColor() {
+	placeholderColor.reset();
+	invalidateRender();
 }
 
-GUILib::Image::~Image() {
-	if (imageTexture)
-		SDL_DestroyTexture(imageTexture);
+std::optional<SDL_Color> GUILib::Image::getPlaceholderColor() const {
+	return placeholderColor;
 }
 
-static SDL_Texture* copyTexture(SDL_Renderer* renderer, SDL_Texture* source) {
-	if (!source) return nullptr;
+void GUILib::Image::setAsyncLoading(bool value) {
+	asyncLoading = value;
+}
 
-	int width, height;
-	Uint32 format;
-	SDL_QueryTexture(source, &format, nullptr, &width, &height);
+bool GUILib::Image::isAsyncLoading() const {
+	return asyncLoading;
+}
 
-	SDL_Texture* newTexture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_TARGET, width, height);
-	if (!newTexture) return nullptr;
+bool GUILib::Image::isLoaded() const {
+	return static_cast<bool>(imageTexture);
+}
 
-	SDL_SetRenderTarget(renderer, newTexture);
-	SDL_RenderCopy(renderer, source, nullptr, nullptr);
-	SDL_SetRenderTarget(renderer, nullptr);
+std::string GUILib::Image::getFilePath() const {
+	return filePath;
+}
 
-	return newTexture;
+std::string GUILib::Image::previousFilePath() const {
+	return prevFilePath;
+}
+
+GUILib::Image::~Image()
+{
+	stopWaiting();
 }
 
 GUILib::Image& GUILib::Image::operator=(const Image& other) {
@@ -98,12 +156,17 @@ GUILib::Image& GUILib::Image::operator=(const Image& other) {
 
 	GuiObject::operator=(other);
 
-	if (imageTexture) SDL_DestroyTexture(imageTexture);
-
-	imageTexture = ref ? copyTexture(ref, other.imageTexture) : nullptr;
+	stopWaiting();
+	imageTexture = other.imageTexture;
 
 	filePath = other.filePath;
 	prevFilePath = other.prevFilePath;
+	placeholderColor = other.placeholderColor;
+	asyncLoading = other.asyncLoading;
+	loading = other.loading;
+	loadFailed = other.loadFailed;
+	// The waiter of the other image calls it back, not this one
+	if (loading) pollTexture();
 
 	return *this;
 }
@@ -112,5 +175,19 @@ GUILib::Image::Image(const Image& other) :
 	GuiObject(other),
 	filePath(other.filePath),
 	prevFilePath(other.prevFilePath),
-	imageTexture(nullptr)
-{}
\ No newline at end of file
+	imageTexture(other.imageTexture),
+	placeholderColor(other.placeholderColor),
+	asyncLoading(other.asyncLoading),
+	loading(other.loading),
+	loadFailed(other.loadFailed)
+{
+	// The waiter of the other image calls it back, not this one
+	if (loading) pollTexture();
+}
+
+GUILib::Reserved::SignalBase* GUILib::Image::findSignal(std::string_view eventName)
+{
+	if (eventName == "onPathChange") return &onPathChange;
+	if (eventName == "onLoaded") return &onLoaded;
+	return GuiObject::findSignal(eventName);
+}
@@ -0,0 +1,147 @@
+#include "imageAtlas.h"
+
+#include <climits>
+
+using namespace GUILib::Reserved;
+
+namespace {
+    std::unordered_map<SDL_Renderer*, std::unique_ptr<ImageAtlas>>& imageAtlases()
+    {
+        static std::unordered_map<SDL_Renderer*, std::unique_ptr<ImageAtlas>> atlases;
+        return atlases;
+    }
+}
+
+SkylinePacker::SkylinePacker(int size) : size(size)
+{
+    reset();
+}
+
+void SkylinePacker::reset()
+{
+    skyline.assign(1, { 0, 0, size });
+}
+
+int SkylinePacker::getSize() const
+{
+    return size;
+}
+
+int SkylinePacker::fit(size_t index, int w, int h) const
+{
+    if (skyline[index].x + w > size) return -1;
+
+    // Rests on the highest segment below it
+    int y = 0;
+    for (size_t i = index, covered = 0; static_cast<int>(covered) < w; ++i) {
+        y = std::max(y, skyline[i].y);
+        if (y + h > size) return -1;
+        covered += skyline[i].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int w, int h, SDL_Point& position)
+{
+    if (w <= 0 || h <= 0 || w > size || h > size) return false;
+
+    // Lowest spot first, the narrowest segment on ties keeps wide gaps for wide images
+    size_t best = skyline.size();
+    int bestY = INT_MAX, bestWidth = INT_MAX;
+    for (size_t i = 0; i < skyline.size(); ++i) {
+        const int y = fit(i, w, h);
+        if (y < 0) continue;
+        if (y < bestY || (y == bestY && skyline[i].width < bestWidth)) {
+            best = i;
+            bestY = y;
+            bestWidth = skyline[i].width;
+        }
+    }
+    if (best == skyline.size()) return false;
+
+    position = { skyline[best].x, bestY };
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(best), { position.x, bestY + h, w });
+
+    // Cut the segments now under the rectangle
+    for (size_t i = best + 1; i < skyline.size();) {
+        const int end = skyline[i - 1].x + skyline[i - 1].width;
+        auto& segment = skyline[i];
+        if (segment.x >= end) break;
+
+        const int overlap = end - segment.x;
+        if (segment.width <= overlap) {
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+            continue;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        break;
+    }
+
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        }
+        else ++i;
+    }
+    return true;
+}
+
+ImageAtlas::ImageAtlas(SDL_Renderer* r) : renderer(r) {}
+
+ImageAtlas& ImageAtlas::get(SDL_Renderer* r)
+{
+    auto& atlas = imageAtlases()[r];
+    if (!atlas) atlas = std::make_unique<ImageAtlas>(r);
+    return *atlas;
+}
+
+void ImageAtlas::releaseRenderer(SDL_Renderer* r)
+{
+    imageAtlases().erase(r);
+}
+
+TextureRegion ImageAtlas::pack(SDL_Surface* surface)
+{
+    // Keeps filtered samples from bleeding into the neighbours
+    constexpr int padding = 1;
+
+    TextureRegion region;
+    if (!renderer || !surface || surface->w > MAX_IMAGE_SIZE || surface->h > MAX_IMAGE_SIZE) return region;
+
+    SDL_Point position {};
+    auto page = pages.begin();
+    while (page != pages.end() && !page->packer.insert(surface->w + padding, surface->h + padding, position)) ++page;
+
+    if (page == pages.end()) {
+        if (pages.size() >= MAX_PAGES) return region;
+
+        SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, PAGE_SIZE, PAGE_SIZE);
+        if (!texture) return region;
+
+        const std::vector<Uint32> transparent(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE, 0);
+        SDL_UpdateTexture(texture, nullptr, transparent.data(), PAGE_SIZE * static_cast<int>(sizeof(Uint32)));
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+        pages.push_back({ SharedTexture(texture, SDL_DestroyTexture), SkylinePacker(PAGE_SIZE) });
+        page = std::prev(pages.end());
+        if (!page->packer.insert(surface->w + padding, surface->h + padding, position)) return region;
+    }
+
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!converted) return region;
+
+    const SDL_Rect area = { position.x, position.y, surface->w, surface->h };
+    SDL_UpdateTexture(page->texture.get(), &area, converted->pixels, converted->pitch);
+    SDL_FreeSurface(converted);
+
+    region.texture = page->texture;
+    region.source = area;
+    return region;
+}
+
+size_t ImageAtlas::pageCount() const
+{
+    return pages.size();
+}
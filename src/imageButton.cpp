@@ -1,5 +1,6 @@
 #include "button.h"
 #include "types.h"
+#include "renderList.h"
 
 int GUILib::ImageButton::nextId = 0;
 
@@ -17,40 +18,27 @@ void GUILib::ImageButton::initialize(SDL_Renderer* renderer) {
     }
 
     ref = renderer;
+    invalidateRender();
 
-    if (hoverTexture) SDL_DestroyTexture(hoverTexture);
-    if (buttonTexture) SDL_DestroyTexture(buttonTexture);
-    SDL_Surface* imgSurf = IMG_Load(defaultImgPath.c_str());
-    SDL_Surface* hoverSurf = IMG_Load(hoverImgPath.c_str());
+    // Buttons showing the same files share the decoded textures
+    auto& cache = Reserved::TextureCache::get(renderer);
+    buttonTexture = cache.load(defaultImgPath);
+    hoverTexture = cache.load(hoverImgPath);
 
-    if (imgSurf == nullptr || hoverSurf == nullptr) {
-        std::cout << "A problem occurred when creating one or more surface for image button, ID: "
-            << id << ". Error: "
-            << SDL_GetError() << '\n';
-        return;
-    }
-    hoverTexture = SDL_CreateTextureFromSurface(renderer, hoverSurf);
-    buttonTexture = SDL_CreateTextureFromSurface(renderer, imgSurf);
-
-    if (hoverTexture == nullptr || buttonTexture == nullptr) {
+    if (!buttonTexture || !hoverTexture) {
         std::cout << "A problem occurred when creating one or more texture for image button, ID: "
             << id << ". Error: "
             << SDL_GetError() << '\n';
-        return;
     }
-
-    SDL_FreeSurface(hoverSurf);
-    SDL_FreeSurface(imgSurf);
 }
 
 void GUILib::ImageButton::render() {
+    update(ref);
     if (!shouldRender()) return;
 
-    SDL_Texture* finalTexture = hovered ? hoverTexture : buttonTexture;
-
-    SDL_RenderCopy(ref, finalTexture, nullptr, &objRect);
+    const auto& finalTexture = hovered ? hoverTexture : buttonTexture;
 
-    SDL_DestroyTexture(finalTexture);
+    Reserved::RenderList::get(ref).copy(finalTexture.texture.get(), finalTexture.source, objRect);
 
     GuiObject::render();
 }
@@ -58,13 +46,13 @@ void GUILib::ImageButton::render() {
 void GUILib::ImageButton::updateDefaultImgPath(const char* path) {
     defaultImgPath = path;
     initialize(ref);
-    trigger("onPathUpdate", path);
+    onPathUpdate.fire(path);
 }
 
 void GUILib::ImageButton::updateHoverImgPath(const char* path) {
     hoverImgPath = path;
     initialize(ref);
-    trigger("onHoverPathUpdate", path);
+    onHoverPathUpdate.fire(path);
 }
 
 int GUILib::ImageButton::getId() const {
@@ -81,8 +69,8 @@ GUILib::ImageButton::ImageButton(
 )
     :
     Button( parent, renderer, size, position ),
-    buttonTexture(nullptr),
-    hoverTexture(nullptr),
+    buttonTexture(),
+    hoverTexture(),
     defaultImgPath(defaultImageFilePath),
     hoverImgPath(hoverImageFilePath),
     id(nextId++)
@@ -91,17 +79,19 @@ GUILib::ImageButton::ImageButton(
 }
 
 GUILib::ImageButton::ImageButton():
-    buttonTexture(nullptr),
-    hoverTexture(nullptr),
+    buttonTexture(),
+    hoverTexture(),
     defaultImgPath(""),
     hoverImgPath(""),
     id(nextId++)
 {
 }
 
-GUILib::ImageButton::~ImageButton() {
-    if (buttonTexture)
-        SDL_DestroyTexture(buttonTexture);
-    if (hoverTexture)
-        SDL_DestroyTexture(hoverTexture);
-}
\ No newline at end of file
+GUILib::ImageButton::~ImageButton() = default;
+
+GUILib::Reserved::SignalBase* GUILib::ImageButton::findSignal(std::string_view eventName)
+{
+    if (eventName == "onPathUpdate") return &onPathUpdate;
+    if (eventName == "onHoverPathUpdate") return &onHoverPathUpdate;
+    return Button::findSignal(eventName);
+}
@@ -0,0 +1,441 @@
+#include "layoutStore.h"
+#include "guiobject.h"
+
+using namespace GUILib::Reserved;
+
+LayoutStore& LayoutStore::get()
+{
+    // Never destroyed: objects with static lifetime give their slot back after every other static is gone
+    static auto* store = new LayoutStore;
+    return *store;
+}
+
+NodeHandle LayoutStore::create(GuiObject* owner)
+{
+    NodeHandle node;
+    if (!freeSlots.empty()) {
+        node = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        node = static_cast<NodeHandle>(owners.size());
+        parents.push_back(INVALID_NODE);
+        firstChildren.push_back(INVALID_NODE);
+        nextSiblings.push_back(INVALID_NODE);
+        previousSiblings.push_back(INVALID_NODE);
+        owners.push_back(nullptr);
+        flags.push_back(0);
+        positionX.push_back(0.0);
+        positionY.push_back(0.0);
+        sizeX.push_back(0.0);
+        sizeY.push_back(0.0);
+        pivotX.push_back(0.0);
+        pivotY.push_back(0.0);
+        rotations.push_back(0.0);
+        contentOffsets.push_back({ 0, 0 });
+        outputSizes.push_back({ 0, 0 });
+        layoutX.push_back(0.0);
+        layoutY.push_back(0.0);
+        layoutW.push_back(0.0);
+        layoutH.push_back(0.0);
+        rects.push_back({ 0, 0, 0, 0 });
+    }
+
+    parents[node] = INVALID_NODE;
+    firstChildren[node] = nextSiblings[node] = previousSiblings[node] = INVALID_NODE;
+    owners[node] = owner;
+    flags[node] = LAYOUT_DIRTY;
+    positionX[node] = positionY[node] = 0.0;
+    sizeX[node] = sizeY[node] = 0.0;
+    pivotX[node] = pivotY[node] = 0.0;
+    rotations[node] = 0.0;
+    contentOffsets[node] = { 0, 0 };
+    outputSizes[node] = { 0, 0 };
+    layoutX[node] = layoutY[node] = layoutW[node] = layoutH[node] = 0.0;
+    rects[node] = { 0, 0, 0, 0 };
+    return node;
+}
+
+void LayoutStore::destroy(NodeHandle node)
+{
+    setParent(node, INVALID_NODE);
+    for (NodeHandle child = firstChildren[node]; child != INVALID_NODE;) {
+        const NodeHandle next = nextSiblings[child];
+        parents[child] = nextSiblings[child] = previousSiblings[child] = INVALID_NODE;
+        flags[child] &= static_cast<std::uint8_t>(~LAID_OUT_TRACKED);
+        child = next;
+    }
+    firstChildren[node] = INVALID_NODE;
+    if (flags[node] & TRACKS_LAID_OUT) laidOutChildren.erase(node);
+
+    flags[node] = 0;
+    owners[node] = nullptr;
+    freeSlots.push_back(node);
+}
+
+void LayoutStore::setOwner(NodeHandle node, GuiObject* owner)
+{
+    owners[node] = owner;
+}
+
+void LayoutStore::copy(NodeHandle from, NodeHandle to)
+{
+    setParent(to, getParent(from));
+    // The children of the slot written stay its own, and so does the tracking of their layout
+    flags[to] = static_cast<std::uint8_t>((flags[from] & (POSITION_SCALED | SIZE_SCALED | PIVOT_SCALED)) | (flags[to] & TRACKS_LAID_OUT) | LAYOUT_DIRTY);
+    positionX[to] = positionX[from];
+    positionY[to] = positionY[from];
+    sizeX[to] = sizeX[from];
+    sizeY[to] = sizeY[from];
+    pivotX[to] = pivotX[from];
+    pivotY[to] = pivotY[from];
+    rotations[to] = rotations[from];
+    contentOffsets[to] = contentOffsets[from];
+    outputSizes[to] = outputSizes[from];
+}
+
+void LayoutStore::setParent(NodeHandle node, NodeHandle parent)
+{
+    const NodeHandle current = parents[node];
+    if (current == parent) return;
+
+    if (current != INVALID_NODE) {
+        untrackLaidOut(node);
+        const NodeHandle previous = previousSiblings[node], next = nextSiblings[node];
+        if (previous != INVALID_NODE) nextSiblings[previous] = next;
+        else firstChildren[current] = next;
+        if (next != INVALID_NODE) previousSiblings[next] = previous;
+    }
+
+    parents[node] = parent;
+    previousSiblings[node] = INVALID_NODE;
+    nextSiblings[node] = INVALID_NODE;
+    if (parent != INVALID_NODE) {
+        const NodeHandle first = firstChildren[parent];
+        nextSiblings[node] = first;
+        if (first != INVALID_NODE) previousSiblings[first] = node;
+        firstChildren[parent] = node;
+    }
+}
+
+NodeHandle LayoutStore::getParent(NodeHandle node) const
+{
+    return parents[node];
+}
+
+NodeHandle LayoutStore::getRoot(NodeHandle node) const
+{
+    while (parents[node] != INVALID_NODE) node = parents[node];
+    return node;
+}
+
+namespace {
+    void setFlag(std::uint8_t& flags, std::uint8_t flag, bool value)
+    {
+        flags = static_cast<std::uint8_t>(value ? flags | flag : flags & ~flag);
+    }
+}
+
+void LayoutStore::setPosition(NodeHandle node, double x, double y, bool scaled)
+{
+    positionX[node] = x;
+    positionY[node] = y;
+    setFlag(flags[node], POSITION_SCALED, scaled);
+}
+
+void LayoutStore::setSize(NodeHandle node, double x, double y, bool scaled)
+{
+    sizeX[node] = x;
+    sizeY[node] = y;
+    setFlag(flags[node], SIZE_SCALED, scaled);
+}
+
+void LayoutStore::setPivot(NodeHandle node, double x, double y, bool scaled)
+{
+    pivotX[node] = x;
+    pivotY[node] = y;
+    setFlag(flags[node], PIVOT_SCALED, scaled);
+}
+
+void LayoutStore::setRotation(NodeHandle node, double degrees)
+{
+    rotations[node] = degrees;
+}
+
+bool LayoutStore::setContentOffset(NodeHandle node, const SDL_Point& offset)
+{
+    SDL_Point& current = contentOffsets[node];
+    if (current.x == offset.x && current.y == offset.y) return false;
+    current = offset;
+
+    if (!(flags[node] & TRACKS_LAID_OUT)) {
+        // Any child may have been laid out with the old offset, the next changes only go through the list
+        flags[node] |= TRACKS_LAID_OUT;
+        markChildrenDirty(node);
+    }
+    else {
+        auto& laidOut = laidOutChildren[node];
+        for (const NodeHandle child : laidOut) {
+            flags[child] &= static_cast<std::uint8_t>(~LAID_OUT_TRACKED);
+            if (markDirty(child)) markChildrenDirty(child);
+        }
+        laidOut.clear();
+    }
+
+    // Children that were out of date already may scroll into view, the layout pass has to come down here anyway
+    markDescendantsDirty(node);
+    return true;
+}
+
+bool LayoutStore::setOutputSize(NodeHandle node, const SDL_Point& outputSize)
+{
+    SDL_Point& current = outputSizes[node];
+    if (current.x == outputSize.x && current.y == outputSize.y) return false;
+    current = outputSize;
+    return true;
+}
+
+bool LayoutStore::markDirty(NodeHandle node)
+{
+    if (flags[node] & LAYOUT_DIRTY) return false;
+    flags[node] |= LAYOUT_DIRTY;
+    return true;
+}
+
+void LayoutStore::markChildrenDirty(NodeHandle node)
+{
+    // Descendants of a dirty object are always dirty, so already dirty subtrees can be skipped
+    bool anyMarked = false;
+    stack.clear();
+    stack.push_back(node);
+    while (!stack.empty()) {
+        const NodeHandle n = stack.back();
+        stack.pop_back();
+        for (NodeHandle child = firstChildren[n]; child != INVALID_NODE; child = nextSiblings[child]) {
+            if (!markDirty(child)) continue;
+            stack.push_back(child);
+            anyMarked = true;
+        }
+    }
+
+    if (anyMarked) markDescendantsDirty(node);
+}
+
+void LayoutStore::markDescendantsDirty(NodeHandle node)
+{
+    // The ancestors of a marked object are always marked
+    for (NodeHandle n = node; n != INVALID_NODE && !(flags[n] & DESCENDANTS_DIRTY); n = getParent(n)) {
+        flags[n] |= DESCENDANTS_DIRTY;
+    }
+}
+
+void LayoutStore::markAncestors(NodeHandle node)
+{
+    if (const NodeHandle p = getParent(node); p != INVALID_NODE) markDescendantsDirty(p);
+}
+
+bool LayoutStore::clearDescendantsDirty(NodeHandle node)
+{
+    if (!(flags[node] & DESCENDANTS_DIRTY)) return false;
+    flags[node] &= static_cast<std::uint8_t>(~DESCENDANTS_DIRTY);
+    return true;
+}
+
+bool LayoutStore::isDirty(NodeHandle node) const
+{
+    return flags[node] & LAYOUT_DIRTY;
+}
+
+bool LayoutStore::needsLayout(NodeHandle node) const
+{
+    return flags[node] & (LAYOUT_DIRTY | DESCENDANTS_DIRTY);
+}
+
+bool LayoutStore::resolve(NodeHandle node)
+{
+    if (!(flags[node] & LAYOUT_DIRTY)) return false;
+
+    // The parent is always resolved first, it's a no-op if its layout is up to date
+    if (const NodeHandle p = getParent(node); p != INVALID_NODE) resolve(p);
+
+    compute(node);
+    return true;
+}
+
+void LayoutStore::compute(NodeHandle node)
+{
+    const std::uint8_t nodeFlags = flags[node];
+    const bool positionScaled = nodeFlags & POSITION_SCALED, sizeScaled = nodeFlags & SIZE_SCALED;
+
+    const NodeHandle p = getParent(node);
+    if (p == INVALID_NODE) {
+        // Root objects are calculated relative to the window
+        SDL_Point& output = outputSizes[node];
+        if (output.x == 0 && output.y == 0 && owners[node]) {
+            if (SDL_Renderer* renderer = owners[node]->getCurrentRenderer())
+                SDL_GetRendererOutputSize(renderer, &output.x, &output.y);
+        }
+
+        layoutW[node] = static_cast<int>(sizeScaled ? output.x * sizeX[node] : sizeX[node]);
+        layoutH[node] = static_cast<int>(sizeScaled ? output.y * sizeY[node] : sizeY[node]);
+        layoutX[node] = static_cast<int>(positionScaled ? output.x * positionX[node] : positionX[node]);
+        layoutY[node] = static_cast<int>(positionScaled ? output.y * positionY[node] : positionY[node]);
+
+        place(node, { static_cast<int>(layoutX[node]), static_cast<int>(layoutY[node]), static_cast<int>(layoutW[node]), static_cast<int>(layoutH[node]) });
+        return;
+    }
+
+    // Through the same kernel as resolveDirty(), so both give the same rects
+    const std::uint64_t positionMask = positionScaled ? UINT64_MAX : 0, sizeMask = sizeScaled ? UINT64_MAX : 0;
+    const double offsetX = contentOffsets[p].x, offsetY = contentOffsets[p].y;
+    SDL_Rect rect {};
+    const UnitBatch batch {
+        &positionX[node], &positionY[node], &positionMask, &sizeX[node], &sizeY[node], &sizeMask,
+        &layoutX[p], &layoutY[p], &layoutW[p], &layoutH[p], &offsetX, &offsetY,
+        &layoutX[node], &layoutY[node], &layoutW[node], &layoutH[node],
+        &rect.x, &rect.y, &rect.w, &rect.h
+    };
+    resolveUnits(batch, 1);
+    place(node, rect);
+}
+
+SDL_Rect LayoutStore::getContentRect(NodeHandle node) const
+{
+    const NodeHandle p = getParent(node);
+    const double parentW = p != INVALID_NODE ? layoutW[p] : 0.0, parentH = p != INVALID_NODE ? layoutH[p] : 0.0;
+    const bool positionScaled = flags[node] & POSITION_SCALED, sizeScaled = flags[node] & SIZE_SCALED;
+    return {
+        static_cast<int>(positionScaled ? parentW * positionX[node] : positionX[node]),
+        static_cast<int>(positionScaled ? parentH * positionY[node] : positionY[node]),
+        static_cast<int>(sizeScaled ? parentW * sizeX[node] : sizeX[node]),
+        static_cast<int>(sizeScaled ? parentH * sizeY[node] : sizeY[node])
+    };
+}
+
+void LayoutStore::place(NodeHandle node, const SDL_Rect& rect)
+{
+    const SDL_Rect previous = rects[node];
+    rects[node] = rect;
+    flags[node] &= static_cast<std::uint8_t>(~LAYOUT_DIRTY);
+
+    // Laid out with the current content offset of the parent, it has to be marked when that changes
+    if (const NodeHandle p = parents[node]; p != INVALID_NODE && (flags[p] & TRACKS_LAID_OUT) && !(flags[node] & LAID_OUT_TRACKED)) {
+        flags[node] |= LAID_OUT_TRACKED;
+        laidOutChildren[p].push_back(node);
+    }
+
+    if (!SDL_RectEquals(&previous, &rect) && owners[node])
+        owners[node]->applyLayout(previous, rect);
+}
+
+void LayoutStore::untrackLaidOut(NodeHandle node)
+{
+    if (!(flags[node] & LAID_OUT_TRACKED)) return;
+    flags[node] &= static_cast<std::uint8_t>(~LAID_OUT_TRACKED);
+
+    auto& laidOut = laidOutChildren[parents[node]];
+    if (const auto it = std::find(laidOut.begin(), laidOut.end(), node); it != laidOut.end()) {
+        *it = laidOut.back();
+        laidOut.pop_back();
+    }
+}
+
+size_t LayoutStore::resolveDirty(const std::vector<NodeHandle>& roots)
+{
+    level.clear();
+    for (const NodeHandle root : roots) {
+        if (root != INVALID_NODE && needsLayout(root)) level.push_back(root);
+    }
+
+    size_t laidOut = 0;
+    while (!level.empty()) {
+        // The parents of a level are up to date, its objects are placed together
+        size_t count = 0;
+        gathered.resize(level.size());
+        for (const NodeHandle node : level) {
+            if (!(flags[node] & LAYOUT_DIRTY)) continue;
+
+            const NodeHandle p = getParent(node);
+            if (p == INVALID_NODE) {
+                compute(node);
+                laidOut++;
+                continue;
+            }
+
+            gathered.nodes[count] = node;
+            gathered.positionX[count] = positionX[node];
+            gathered.positionY[count] = positionY[node];
+            gathered.positionMask[count] = (flags[node] & POSITION_SCALED) ? UINT64_MAX : 0;
+            gathered.sizeX[count] = sizeX[node];
+            gathered.sizeY[count] = sizeY[node];
+            gathered.sizeMask[count] = (flags[node] & SIZE_SCALED) ? UINT64_MAX : 0;
+            gathered.parentX[count] = layoutX[p];
+            gathered.parentY[count] = layoutY[p];
+            gathered.parentW[count] = layoutW[p];
+            gathered.parentH[count] = layoutH[p];
+            gathered.offsetX[count] = contentOffsets[p].x;
+            gathered.offsetY[count] = contentOffsets[p].y;
+            count++;
+        }
+        computeGathered(count);
+        laidOut += count;
+
+        // Every object of the level was out of date or had such descendants, the next level is their children that need it
+        nextLevel.clear();
+        for (const NodeHandle node : level) {
+            clearDescendantsDirty(node);
+            if (firstChildren[node] == INVALID_NODE) continue;
+
+            // Only the children in view, which spares the ones scrolled away
+            if (GuiObject* owner = owners[node]; owner && owner->clipsChildren()) {
+                owner->forEachChildInView([this](GuiObject* child) {
+                    if (child && needsLayout(child->node)) nextLevel.push_back(child->node);
+                });
+                continue;
+            }
+            for (NodeHandle child = firstChildren[node]; child != INVALID_NODE; child = nextSiblings[child]) {
+                if (needsLayout(child)) nextLevel.push_back(child);
+            }
+        }
+        level.swap(nextLevel);
+    }
+    return laidOut;
+}
+
+void LayoutStore::computeGathered(size_t count)
+{
+    resolveUnits(gathered.batch(), count);
+
+    for (size_t k = 0; k < count; ++k) {
+        const NodeHandle node = gathered.nodes[k];
+        layoutX[node] = gathered.x[k];
+        layoutY[node] = gathered.y[k];
+        layoutW[node] = gathered.w[k];
+        layoutH[node] = gathered.h[k];
+        place(node, { gathered.rectX[k], gathered.rectY[k], gathered.rectW[k], gathered.rectH[k] });
+    }
+}
+
+void LayoutStore::Gathered::resize(size_t count)
+{
+    if (nodes.size() >= count) return;
+    nodes.resize(count);
+    for (auto* v : { &positionX, &positionY, &sizeX, &sizeY, &parentX, &parentY, &parentW, &parentH, &offsetX, &offsetY, &x, &y, &w, &h }) v->resize(count);
+    for (auto* v : { &positionMask, &sizeMask }) v->resize(count);
+    for (auto* v : { &rectX, &rectY, &rectW, &rectH }) v->resize(count);
+}
+
+UnitBatch LayoutStore::Gathered::batch()
+{
+    return {
+        positionX.data(), positionY.data(), positionMask.data(), sizeX.data(), sizeY.data(), sizeMask.data(),
+        parentX.data(), parentY.data(), parentW.data(), parentH.data(), offsetX.data(), offsetY.data(),
+        x.data(), y.data(), w.data(), h.data(),
+        rectX.data(), rectY.data(), rectW.data(), rectH.data()
+    };
+}
+
+size_t LayoutStore::size() const
+{
+    return owners.size() - freeSlots.size();
+}
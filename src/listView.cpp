@@ -0,0 +1,261 @@
+#include "listView.h"
+
+GUILib::ListView::ListView()
+{
+    shouldRenderChildren = true;
+}
+
+int GUILib::ListView::columnCount(int) const
+{
+    return 1;
+}
+
+SDL_Point GUILib::ListView::cellSize(int viewportWidth) const
+{
+    return { viewportWidth, itemHeight };
+}
+
+void GUILib::ListView::refreshContentSize(const SDL_Rect& viewport, int columns, const SDL_Point& cell)
+{
+    const size_t rows = (itemCount + columns - 1) / columns;
+    const double height = static_cast<double>(rows) * cell.y;
+
+    // In pixels, setContentSize() would read them relative to the size of the frame
+    contentSize = { static_cast<double>(viewport.w), height, false };
+    updateScrollbars();
+
+    const int maxScrollY = std::max(0, static_cast<int>(height) - viewport.h);
+    if (scrollY > maxScrollY) {
+        scrollY = maxScrollY;
+        invalidateContentOffset();
+    }
+}
+
+void GUILib::ListView::syncViews()
+{
+    const SDL_Rect viewport = getRect();
+    const int columns = std::max(1, columnCount(viewport.w));
+    const SDL_Point cell = cellSize(viewport.w);
+
+    refreshContentSize(viewport, columns, cell);
+
+    if (!rebindAll && scrollY == placedScrollY && SDL_RectEquals(&viewport, &placedViewport)) return;
+
+    // The rows touching the viewport, plus the overscan
+    size_t first = 0, end = 0;
+    if (cell.y > 0) {
+        const size_t rows = (itemCount + columns - 1) / columns;
+        const size_t firstRow = static_cast<size_t>(std::max(0, scrollY / cell.y - overscan));
+        const size_t endRow = std::min(rows, static_cast<size_t>((scrollY + viewport.h + cell.y - 1) / cell.y + overscan));
+        first = std::min(firstRow * columns, itemCount);
+        end = std::max(first, std::min(endRow * columns, itemCount));
+    }
+
+    // Keep the views of the items that stay in range, recycle the others
+    std::vector<std::shared_ptr<GuiObject>> views(end - first);
+    for (size_t i = 0; i < boundViews.size(); ++i) {
+        auto& view = boundViews[i];
+        if (!view) continue;
+
+        const size_t index = firstBound + i;
+        if (index >= first && index < end) views[index - first] = std::move(view);
+        else recycleView(std::move(view));
+    }
+
+    for (size_t i = 0; i < views.size(); ++i) {
+        auto& view = views[i];
+        const bool isNew = !view;
+        if (isNew) view = obtainView();
+        if (!view) continue;
+
+        const size_t index = first + i;
+        placeView(view, index, columns, cell);
+        if ((isNew || rebindAll) && binder) binder(view, index);
+    }
+
+    boundViews = std::move(views);
+    firstBound = first;
+
+    rebindAll = false;
+    placedScrollY = scrollY;
+    placedViewport = viewport;
+}
+
+void GUILib::ListView::updateChildrenLayout()
+{
+    // Binding during the render would move views while the scene is recorded, and lay them out a frame late
+    syncViews();
+    ScrollingFrame::updateChildrenLayout();
+}
+
+void GUILib::ListView::forEachChildInView(const std::function<void(GuiObject*)>& callback)
+{
+    syncViews();
+    ScrollingFrame::forEachChildInView(callback);
+}
+
+void GUILib::ListView::scroll(int deltaX, int deltaY)
+{
+    ScrollingFrame::scroll(deltaX, deltaY);
+    syncViews();
+}
+
+std::shared_ptr<GUILib::GuiObject> GUILib::ListView::obtainView()
+{
+    if (!recycledViews.empty()) {
+        auto view = std::move(recycledViews.back());
+        recycledViews.pop_back();
+        view->setVisible(true);
+        return view;
+    }
+
+    if (!factory) return nullptr;
+    auto view = factory();
+    if (!view) return nullptr;
+
+    view->updateRenderer(ref);
+    view->setParent(shared_from_this());
+    return view;
+}
+
+void GUILib::ListView::recycleView(std::shared_ptr<GuiObject> view)
+{
+    view->setVisible(false);
+    recycledViews.push_back(std::move(view));
+}
+
+void GUILib::ListView::placeView(const std::shared_ptr<GuiObject>& view, size_t index, int columns, const SDL_Point& cell) const
+{
+    const auto column = static_cast<int>(index % columns);
+    const auto row = static_cast<double>(index / columns);
+
+    // Only touch the views that actually moved, their layout stays cached otherwise
+    const UIUnit newPosition = { static_cast<double>(column) * cell.x, row * cell.y, false };
+    const UIUnit newSize = { static_cast<double>(cell.x), static_cast<double>(cell.y), false };
+    if (!(view->getPosition() == newPosition)) view->move(newPosition);
+    if (!(view->getSize() == newSize)) view->resize(newSize);
+}
+
+void GUILib::ListView::setItemFactory(ItemFactory itemFactory)
+{
+    factory = std::move(itemFactory);
+
+    // Views from the old factory may not suit the binder anymore
+    for (const auto& view : boundViews) {
+        if (view) view->setParent(nullptr);
+    }
+    for (const auto& view : recycledViews) {
+        view->setParent(nullptr);
+    }
+    boundViews.clear();
+    recycledViews.clear();
+    placedScrollY = -1;
+    syncViews();
+    invalidateRender();
+}
+
+void GUILib::ListView::setItemBinder(ItemBinder itemBinder)
+{
+    binder = std::move(itemBinder);
+    rebindAll = true;
+    syncViews();
+    invalidateRender();
+}
+
+void GUILib::ListView::setItemCount(size_t count)
+{
+    itemCount = count;
+    rebindAll = true;
+    syncViews();
+    invalidateRender();
+}
+
+size_t GUILib::ListView::getItemCount() const
+{
+    return itemCount;
+}
+
+void GUILib::ListView::setItemHeight(int height)
+{
+    itemHeight = std::max(1, height);
+    placedScrollY = -1;
+    syncViews();
+    invalidateRender();
+}
+
+int GUILib::ListView::getItemHeight() const
+{
+    return itemHeight;
+}
+
+void GUILib::ListView::setOverscan(int rows)
+{
+    overscan = std::max(0, rows);
+    placedScrollY = -1;
+    syncViews();
+    invalidateRender();
+}
+
+int GUILib::ListView::getOverscan() const
+{
+    return overscan;
+}
+
+void GUILib::ListView::refreshItems()
+{
+    rebindAll = true;
+    syncViews();
+    invalidateRender();
+}
+
+void GUILib::ListView::refreshItem(size_t index)
+{
+    if (const auto view = getItemView(index); view && binder) binder(view, index);
+}
+
+std::shared_ptr<GUILib::GuiObject> GUILib::ListView::getItemView(size_t index) const
+{
+    if (index < firstBound || index - firstBound >= boundViews.size()) return nullptr;
+    return boundViews[index - firstBound];
+}
+
+void GUILib::ListView::scrollToItem(size_t index)
+{
+    if (index >= itemCount) return;
+
+    const SDL_Rect viewport = getRect();
+    const int columns = std::max(1, columnCount(viewport.w));
+    const SDL_Point cell = cellSize(viewport.w);
+    refreshContentSize(viewport, columns, cell);
+
+    const int top = static_cast<int>(index / columns) * cell.y;
+    if (top < scrollY) {
+        scroll(0, top - scrollY);
+    }
+    else if (top + cell.y > scrollY + viewport.h) {
+        scroll(0, top + cell.y - viewport.h - scrollY);
+    }
+}
+
+int GUILib::GridView::columnCount(int viewportWidth) const
+{
+    return std::max(1, viewportWidth / itemWidth);
+}
+
+SDL_Point GUILib::GridView::cellSize(int) const
+{
+    return { itemWidth, itemHeight };
+}
+
+void GUILib::GridView::setItemWidth(int width)
+{
+    itemWidth = std::max(1, width);
+    placedScrollY = -1;
+    syncViews();
+    invalidateRender();
+}
+
+int GUILib::GridView::getItemWidth() const
+{
+    return itemWidth;
+}
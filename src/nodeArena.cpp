@@ -0,0 +1,31 @@
+#include "nodeArena.h"
+
+using namespace GUILib::Reserved;
+
+NodeArena::NodeArena(size_t chunkSize) : resource(std::max<size_t>(chunkSize, 1)) {}
+
+void* NodeArena::allocate(size_t bytes, size_t alignment)
+{
+    this->bytes += bytes;
+    return resource.allocate(bytes, alignment);
+}
+
+size_t NodeArena::getBytes() const
+{
+    return bytes;
+}
+
+const std::shared_ptr<NodeArena>& NodeArena::current()
+{
+    return active;
+}
+
+GUILib::ArenaScope::ArenaScope(std::shared_ptr<NodeArena> arena) : previous(std::move(NodeArena::active))
+{
+    NodeArena::active = std::move(arena);
+}
+
+GUILib::ArenaScope::~ArenaScope()
+{
+    NodeArena::active = std::move(previous);
+}
@@ -0,0 +1,360 @@
+#include "renderList.h"
+#include "glyphAtlas.h"
+
+using namespace GUILib::Reserved;
+
+namespace {
+    std::unordered_map<SDL_Renderer*, std::unique_ptr<RenderList>>& renderLists()
+    {
+        static std::unordered_map<SDL_Renderer*, std::unique_ptr<RenderList>> lists;
+        return lists;
+    }
+
+    bool isUnrotated(double angle)
+    {
+        return std::fmod(angle, 360.0) == 0.0;
+    }
+
+    constexpr double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+    constexpr SDL_Color WHITE = { 255, 255, 255, 255 };
+
+    /// @brief Draws quads, four vertices each.
+    void drawQuads(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Vertex* vertices, size_t count)
+    {
+        const size_t quadCount = count / 4;
+        const auto& indices = quadIndices(quadCount);
+        SDL_RenderGeometry(renderer, texture,
+            vertices, static_cast<int>(count),
+            indices.data(), static_cast<int>(quadCount * 6));
+    }
+
+    /// @brief Returns whether the bounding box of a quad overlaps the rect.
+    bool quadIntersects(const SDL_Vertex* quad, const SDL_Rect& rect)
+    {
+        float minX = quad[0].position.x, maxX = minX, minY = quad[0].position.y, maxY = minY;
+        for (int i = 1; i < 4; ++i) {
+            minX = std::min(minX, quad[i].position.x);
+            maxX = std::max(maxX, quad[i].position.x);
+            minY = std::min(minY, quad[i].position.y);
+            maxY = std::max(maxY, quad[i].position.y);
+        }
+        return maxX > static_cast<float>(rect.x) && minX < static_cast<float>(rect.x + rect.w)
+            && maxY > static_cast<float>(rect.y) && minY < static_cast<float>(rect.y + rect.h);
+    }
+}
+
+RenderList::RenderList(SDL_Renderer* r) : renderer(r) {}
+
+RenderList& RenderList::get(SDL_Renderer* r)
+{
+    auto& list = renderLists()[r];
+    if (!list) list = std::make_unique<RenderList>(r);
+    return *list;
+}
+
+void RenderList::releaseRenderer(SDL_Renderer* r)
+{
+    renderLists().erase(r);
+}
+
+void RenderList::begin()
+{
+    clear();
+    recording = true;
+}
+
+void RenderList::end()
+{
+    recording = false;
+    clips.clear();
+}
+
+bool RenderList::isRecording() const
+{
+    return recording;
+}
+
+void RenderList::clear()
+{
+    vertices.clear();
+    runs.clear();
+    clips.clear();
+    submitted = false;
+}
+
+void RenderList::pushLayer()
+{
+    layers.push_back({ std::move(vertices), std::move(runs), std::move(clips), recording, submitted });
+    vertices.clear();
+    runs.clear();
+    clips.clear();
+    recording = true;
+    submitted = false;
+}
+
+void RenderList::popLayer()
+{
+    if (layers.empty()) return;
+
+    auto& layer = layers.back();
+    vertices = std::move(layer.vertices);
+    runs = std::move(layer.runs);
+    clips = std::move(layer.clips);
+    recording = layer.recording;
+    submitted = layer.submitted;
+    layers.pop_back();
+}
+
+void RenderList::translate(int dx, int dy)
+{
+    const float x = static_cast<float>(dx), y = static_cast<float>(dy);
+    for (auto& v : vertices) {
+        v.position.x += x;
+        v.position.y += y;
+    }
+    for (auto& run : runs) {
+        run.clip.x += dx;
+        run.clip.y += dy;
+    }
+    for (auto& clip : clips) {
+        clip.x += dx;
+        clip.y += dy;
+    }
+}
+
+size_t RenderList::runCount() const
+{
+    return runs.size();
+}
+
+void RenderList::submit(const SDL_Rect* area)
+{
+    if (!renderer) return;
+    if (submitted) stats.replays++;
+    submitted = true;
+    if (runs.empty()) return;
+
+    // Leave the renderer as it was found
+    const bool wasClipped = SDL_RenderIsClipEnabled(renderer);
+    SDL_Rect previousClip {};
+    SDL_RenderGetClipRect(renderer, &previousClip);
+    SDL_BlendMode previousMode = SDL_BLENDMODE_NONE;
+    SDL_GetRenderDrawBlendMode(renderer, &previousMode);
+
+    // Plain colored quads take the draw blend mode
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    const Run* previous = nullptr;
+    SDL_Texture* previousTexture = nullptr;
+    bool first = true;
+    for (const auto& run : runs) {
+        if (area) {
+            SDL_Rect clip = *area;
+            if (run.clipped && !SDL_IntersectRect(&run.clip, area, &clip)) continue;
+            SDL_RenderSetClipRect(renderer, &clip);
+
+            // The renderer would clip them anyway, but only after transforming them
+            culled.clear();
+            for (size_t i = run.first; i < run.first + run.count; i += 4) {
+                if (quadIntersects(vertices.data() + i, clip)) culled.insert(culled.end(), vertices.begin() + i, vertices.begin() + i + 4);
+            }
+            if (culled.empty()) continue;
+
+            drawRun(run.texture, culled.data(), culled.size(), previousTexture, first);
+            continue;
+        }
+
+        if (!previous || previous->clipped != run.clipped || (run.clipped && !SDL_RectEquals(&previous->clip, &run.clip))) {
+            SDL_RenderSetClipRect(renderer, run.clipped ? &run.clip : nullptr);
+        }
+        previous = &run;
+
+        drawRun(run.texture, vertices.data() + run.first, run.count, previousTexture, first);
+    }
+
+    SDL_RenderSetClipRect(renderer, wasClipped ? &previousClip : nullptr);
+    SDL_SetRenderDrawBlendMode(renderer, previousMode);
+}
+
+void RenderList::drawRun(SDL_Texture* texture, const SDL_Vertex* runVertices, size_t count, SDL_Texture*& previousTexture, bool& first)
+{
+    drawQuads(renderer, texture, runVertices, count);
+    stats.drawCalls++;
+    if (first || texture != previousTexture) stats.textureSwitches++;
+    previousTexture = texture;
+    first = false;
+}
+
+bool RenderList::isClippedOut() const
+{
+    return !clips.empty() && (clips.back().w <= 0 || clips.back().h <= 0);
+}
+
+void RenderList::applyClip() const
+{
+    // An empty rect would turn clipping off, nothing is drawn while clipped out anyway
+    if (clips.empty()) SDL_RenderSetClipRect(renderer, nullptr);
+    else if (!isClippedOut()) SDL_RenderSetClipRect(renderer, &clips.back());
+}
+
+void RenderList::emit(SDL_Texture* texture, const SDL_Vertex* quadVertices, size_t count)
+{
+    if (!recording) {
+        SDL_BlendMode previousMode = SDL_BLENDMODE_NONE;
+        if (!texture) {
+            SDL_GetRenderDrawBlendMode(renderer, &previousMode);
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        }
+        drawQuads(renderer, texture, quadVertices, count);
+        if (!texture) SDL_SetRenderDrawBlendMode(renderer, previousMode);
+        stats.immediateDraws++;
+        return;
+    }
+
+    const bool clipped = !clips.empty();
+    const SDL_Rect clip = clipped ? clips.back() : SDL_Rect {};
+    const bool continuesRun = !runs.empty()
+        && runs.back().texture == texture
+        && runs.back().clipped == clipped
+        && (!clipped || SDL_RectEquals(&runs.back().clip, &clip));
+    if (!continuesRun) runs.push_back({ texture, clip, clipped, vertices.size(), 0 });
+    else stats.merged++;
+
+    vertices.insert(vertices.end(), quadVertices, quadVertices + count);
+    runs.back().count += count;
+    stats.commands++;
+}
+
+void RenderList::emitQuad(SDL_Texture* texture, const SDL_Rect& dest, double angle, const SDL_Point* pivot, const SDL_Color& color, SDL_FPoint uv0, SDL_FPoint uv1)
+{
+    const float x = static_cast<float>(dest.x), y = static_cast<float>(dest.y);
+    const float w = static_cast<float>(dest.w), h = static_cast<float>(dest.h);
+
+    SDL_FPoint corners[4] = { { x, y }, { x + w, y }, { x + w, y + h }, { x, y + h } };
+    if (!isUnrotated(angle)) {
+        // Turned around the pivot, like SDL_RenderCopyEx()
+        const float pivotX = x + (pivot ? static_cast<float>(pivot->x) : w / 2.0f);
+        const float pivotY = y + (pivot ? static_cast<float>(pivot->y) : h / 2.0f);
+        const float radians = static_cast<float>(std::fmod(angle, 360.0) * DEGREES_TO_RADIANS);
+        const float c = std::cos(radians), s = std::sin(radians);
+        for (auto& corner : corners) {
+            const float rx = corner.x - pivotX, ry = corner.y - pivotY;
+            corner = { pivotX + rx * c - ry * s, pivotY + rx * s + ry * c };
+        }
+    }
+
+    const SDL_Vertex quad[4] = {
+        { corners[0], color, { uv0.x, uv0.y } },
+        { corners[1], color, { uv1.x, uv0.y } },
+        { corners[2], color, { uv1.x, uv1.y } },
+        { corners[3], color, { uv0.x, uv1.y } },
+    };
+    emit(texture, quad, 4);
+}
+
+void RenderList::fill(const SDL_Color& color, const SDL_Rect& rect, double angle, const SDL_Point* pivot)
+{
+    if (!renderer || rect.w <= 0 || rect.h <= 0 || isClippedOut()) return;
+
+    // Unrotated boxes are cheaper filled directly than as geometry
+    if (!recording && isUnrotated(angle)) {
+        SDL_BlendMode previousMode = SDL_BLENDMODE_NONE;
+        SDL_GetRenderDrawBlendMode(renderer, &previousMode);
+
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRect(renderer, &rect);
+        SDL_SetRenderDrawBlendMode(renderer, previousMode);
+        return;
+    }
+
+    emitQuad(nullptr, rect, angle, pivot, color, { 0.0f, 0.0f }, { 0.0f, 0.0f });
+}
+
+void RenderList::copy(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest, double angle, const SDL_Point* pivot, SDL_RendererFlip flip)
+{
+    if (!renderer || !texture || isClippedOut()) return;
+
+    if (!recording) {
+        SDL_RenderCopyEx(renderer, texture, &source, &dest, angle, pivot, flip);
+        stats.immediateDraws++;
+        return;
+    }
+
+    int w = 1, h = 1;
+    SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+    const float textureWidth = static_cast<float>(std::max(1, w)), textureHeight = static_cast<float>(std::max(1, h));
+
+    SDL_FPoint uv0 = { source.x / textureWidth, source.y / textureHeight };
+    SDL_FPoint uv1 = { (source.x + source.w) / textureWidth, (source.y + source.h) / textureHeight };
+    if (flip & SDL_FLIP_HORIZONTAL) std::swap(uv0.x, uv1.x);
+    if (flip & SDL_FLIP_VERTICAL) std::swap(uv0.y, uv1.y);
+
+    emitQuad(texture, dest, angle, pivot, WHITE, uv0, uv1);
+}
+
+void RenderList::quads(SDL_Texture* texture, const std::vector<SDL_Vertex>& quadVertices)
+{
+    if (!renderer || quadVertices.empty() || isClippedOut()) return;
+    emit(texture, quadVertices.data(), quadVertices.size());
+}
+
+void RenderList::line(const SDL_Color& color, int x1, int y1, int x2, int y2)
+{
+    if (!renderer || isClippedOut()) return;
+
+    if (!recording) {
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+        stats.immediateDraws++;
+        return;
+    }
+
+    // A quad one pixel wide, covering the pixels of both ends
+    const float dx = static_cast<float>(x2 - x1), dy = static_cast<float>(y2 - y1);
+    const float length = std::sqrt(dx * dx + dy * dy);
+    const float ux = length > 0.0f ? dx / length * 0.5f : 0.5f, uy = length > 0.0f ? dy / length * 0.5f : 0.0f;
+    const float ax = x1 + 0.5f - ux, ay = y1 + 0.5f - uy;
+    const float bx = x2 + 0.5f + ux, by = y2 + 0.5f + uy;
+
+    const SDL_Vertex quad[4] = {
+        { { ax + uy, ay - ux }, color, { 0.0f, 0.0f } },
+        { { bx + uy, by - ux }, color, { 0.0f, 0.0f } },
+        { { bx - uy, by + ux }, color, { 0.0f, 0.0f } },
+        { { ax - uy, ay + ux }, color, { 0.0f, 0.0f } },
+    };
+    emit(nullptr, quad, 4);
+}
+
+void RenderList::pushClip(const SDL_Rect& rect)
+{
+    SDL_Rect clip = rect;
+    if (!clips.empty() && !SDL_IntersectRect(&clips.back(), &rect, &clip)) clip = { rect.x, rect.y, 0, 0 };
+    clips.push_back(clip);
+
+    if (!recording) applyClip();
+}
+
+void RenderList::popClip()
+{
+    if (clips.empty()) return;
+    clips.pop_back();
+
+    if (!recording) applyClip();
+}
+
+const RenderList::Stats& RenderList::getStats() const
+{
+    return stats;
+}
+
+void RenderList::resetStats()
+{
+    stats = Stats();
+}
+
+void GUILib::Reserved::renderSolidBox(SDL_Renderer* r, const SDL_Color& color, const SDL_Rect& rect, double angle, const SDL_Point* pivot)
+{
+    if (!r) return;
+    RenderList::get(r).fill(color, rect, angle, pivot);
+}
@@ -1,43 +1,507 @@
 #include "guimanager.h"
+#include "renderList.h"
+#include "glyphAtlas.h"
+#include "textureCache.h"
+#include "imageAtlas.h"
+#include "damageTracker.h"
+#include "framePacer.h"
 
 void GUILib::SceneManager::add(std::shared_ptr<GuiObject> obj) {
     if (!obj || obj->hasParent()) return; // Push the hell parent in
     objects.push_back(obj);
+    indexDirty = true;
+    renderDirty = true;
 }
 
 void GUILib::SceneManager::render() {
     if (!ref) return;
+
+    // Images whose file came in are called back, and draw it this frame
+    Reserved::TextureCache::get(ref).uploadDecoded();
+
+    // Queried once per frame, however many resize events came in since the last one
+    SDL_GetRendererOutputSize(ref, &outputSize.x, &outputSize.y);
+
+    resizedRoots.clear();
     for (const auto& obj : objects) {
         if (!obj) continue;
         obj->updateRenderer(ref);
-        obj->render();
+        if (obj->setOutputSize(outputSize)) resizedRoots.push_back(obj->node);
+    }
+    // Every root that changed size is laid out in the same pass, the whole output is drawn again anyway
+    if (!resizedRoots.empty()) {
+        Reserved::DamageTracker::get(ref).addAll();
+        // Rebuilt for the new size anyway, no need to follow every object the resize moves
+        index.clear();
+        GuiObject::resolveLayouts(resizedRoots);
+    }
+
+    // Restored even if something throws, objects rendered on their own keep querying the output size
+    struct SceneRendererScope {
+        explicit SceneRendererScope(SDL_Renderer* r) : previous(GuiObject::sceneRenderer) { GuiObject::sceneRenderer = r; }
+        ~SceneRendererScope() { GuiObject::sceneRenderer = previous; }
+        SDL_Renderer* previous;
+    } scope(ref);
+
+    for (const auto& obj : objects) {
+        if (obj) obj->updateLayout();
+    }
+
+    // Laid out first, so the revision already covers the geometry of this frame
+    const std::uint64_t revision = GuiObject::getRenderRevision();
+
+    auto& renderList = Reserved::RenderList::get(ref);
+    if (renderDirty || revision != recordedRevision || outputSize.x != recordedOutputSize.x || outputSize.y != recordedOutputSize.y) {
+        // Objects added or removed don't report where they were
+        if (renderDirty) Reserved::DamageTracker::get(ref).addAll();
+
+        renderList.begin();
+        for (const auto& obj : objects) {
+            if (obj) obj->draw();
+        }
+        renderList.end();
+
+        recordedRevision = revision;
+        recordedOutputSize = outputSize;
+        renderDirty = false;
+    }
+
+    if (damageTracking && prepareTarget(outputSize)) {
+        presentTarget();
+    }
+    else {
+        renderList.submit();
+    }
+}
+
+bool GUILib::SceneManager::prepareTarget(const SDL_Point& outputSize)
+{
+    if (outputSize.x <= 0 || outputSize.y <= 0 || !SDL_RenderTargetSupported(ref)) return false;
+    if (target && targetSize.x == outputSize.x && targetSize.y == outputSize.y) return true;
+
+    target.reset();
+    SDL_Texture* created = SDL_CreateTexture(ref, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, outputSize.x, outputSize.y);
+    if (!created) return false;
+
+    // Copied over the output as is, the background is part of it
+    SDL_SetTextureBlendMode(created, SDL_BLENDMODE_NONE);
+    target = Reserved::SharedTexture(created, SDL_DestroyTexture);
+    targetSize = outputSize;
+
+    Reserved::DamageTracker::get(ref).addAll();
+    return true;
+}
+
+void GUILib::SceneManager::presentTarget()
+{
+    const auto regions = Reserved::DamageTracker::get(ref).take({ 0, 0, targetSize.x, targetSize.y });
+
+    if (!regions.empty()) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(ref);
+        SDL_BlendMode previousMode = SDL_BLENDMODE_NONE;
+        SDL_GetRenderDrawBlendMode(ref, &previousMode);
+        Uint8 r = 0, g = 0, b = 0, a = 0;
+        SDL_GetRenderDrawColor(ref, &r, &g, &b, &a);
+
+        SDL_SetRenderTarget(ref, target.get());
+        auto& renderList = Reserved::RenderList::get(ref);
+        for (const auto& region : regions) {
+            SDL_SetRenderDrawBlendMode(ref, SDL_BLENDMODE_NONE);
+            SDL_SetRenderDrawColor(ref, backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a);
+            SDL_RenderFillRect(ref, &region);
+            renderList.submit(&region);
+        }
+        SDL_SetRenderTarget(ref, previousTarget);
+
+        SDL_SetRenderDrawColor(ref, r, g, b, a);
+        SDL_SetRenderDrawBlendMode(ref, previousMode);
+    }
+
+    SDL_RenderCopy(ref, target.get(), nullptr, nullptr);
+}
+
+const std::shared_ptr<GUILib::Reserved::NodeArena>& GUILib::SceneManager::getArena() const
+{
+    return arena;
+}
+
+GUILib::TweenScheduler& GUILib::SceneManager::getTweens()
+{
+    return tweens;
+}
+
+void GUILib::SceneManager::setDamageTracking(bool value)
+{
+    damageTracking = value;
+    if (!value) target.reset();
+}
+
+bool GUILib::SceneManager::isDamageTracking() const
+{
+    return damageTracking;
+}
+
+void GUILib::SceneManager::setBackgroundColor(const SDL_Color& color)
+{
+    backgroundColor = color;
+    if (ref) Reserved::DamageTracker::get(ref).addAll();
+}
+
+SDL_Color GUILib::SceneManager::getBackgroundColor() const
+{
+    return backgroundColor;
+}
+
+void GUILib::SceneManager::invalidate()
+{
+    renderDirty = true;
+}
+
+bool GUILib::SceneManager::needsRender() const
+{
+    if (renderDirty || GuiObject::getRenderRevision() != recordedRevision) return true;
+
+    // Moved objects are only laid out by render(), which bumps the revision
+    const auto& store = Reserved::LayoutStore::get();
+    return std::any_of(objects.begin(), objects.end(),
+        [&](const std::shared_ptr<GuiObject>& obj) { return obj && store.needsLayout(obj->node); });
+}
+
+void GUILib::SceneManager::update(double deltaTime)
+{
+    tweens.update(deltaTime);
+}
+
+void GUILib::SceneManager::run(const RunOptions& options)
+{
+    using Clock = std::chrono::steady_clock;
+    const double step = options.updateStep > 0 ? options.updateStep : 1.0 / 120.0;
+    const auto seconds = [](double value) { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(value)); };
+    Reserved::FramePacer pacer(options.frameRate > 0 ? seconds(1.0 / options.frameRate) : Clock::duration::zero(), seconds(options.spinMargin));
+
+    frameStats = {};
+    running = true;
+    // Something may have turned text input on since the scene was created
+    focus.refreshTextInput();
+    double pending = 0;
+    Clock::time_point frameStart = Clock::now();
+
+    while (running) {
+        SDL_Event e;
+        // Nothing moving and nothing to draw: sleep until something happens, or until an object wants to be drawn again
+        if (tweens.size() == 0 && !needsRender()) {
+            int timeout = std::max(options.maxIdleWait, 1);
+            if (GuiObject::renderDeadline != Clock::time_point::max()) {
+                const auto untilDeadline = std::chrono::ceil<std::chrono::milliseconds>(GuiObject::renderDeadline - Clock::now()).count();
+                timeout = static_cast<int>(std::clamp<long long>(untilDeadline, 0, timeout));
+            }
+            frameStats.idleWaits++;
+            if (SDL_WaitEventTimeout(&e, timeout)) {
+                if (e.type == SDL_MOUSEMOTION) coalesceMotion(e);
+                dispatchRunEvent(e, options);
+            }
+
+            // The time asleep is neither stepped through nor counted as a frame
+            pending = 0;
+            frameStart = Clock::now();
+            pacer.reset();
+        }
+        while (running && pollEvent(e)) dispatchRunEvent(e, options);
+        if (!running) break;
+
+        // Fixed steps, whatever the frame rate. Past the limit the time left is dropped
+        int updates = 0;
+        for (; pending >= step && updates < options.maxUpdatesPerFrame; ++updates) {
+            update(step);
+            if (options.onUpdate) options.onUpdate(step);
+            pending -= step;
+        }
+        if (pending >= step) pending = 0;
+        frameStats.updates += static_cast<std::uint64_t>(updates);
+
+        // Woken up by the workers when a file is decoded, the images waiting on it want to be drawn
+        Reserved::TextureCache::get(ref).uploadDecoded();
+
+        if (needsRender()) {
+            if (!damageTracking) {
+                SDL_SetRenderDrawColor(ref, backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a);
+                SDL_RenderClear(ref);
+            }
+            render();
+            if (options.onRender) options.onRender();
+            SDL_RenderPresent(ref);
+            frameStats.renderedFrames++;
+        }
+        else {
+            frameStats.skippedFrames++;
+        }
+
+        const Clock::time_point workEnd = Clock::now();
+        pacer.wait();
+        const Clock::time_point frameEnd = Clock::now();
+
+        pending += std::chrono::duration<double>(frameEnd - frameStart).count();
+        recordFrame(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count(),
+            std::chrono::duration<double, std::milli>(workEnd - frameStart).count());
+        frameStart = frameEnd;
+    }
+    running = false;
+}
+
+void GUILib::SceneManager::stop()
+{
+    running = false;
+}
+
+const GUILib::FrameStats& GUILib::SceneManager::getFrameStats() const
+{
+    return frameStats;
+}
+
+bool GUILib::SceneManager::pollEvent(SDL_Event& e)
+{
+    if (!SDL_PollEvent(&e)) return false;
+    if (e.type == SDL_MOUSEMOTION) coalesceMotion(e);
+    return true;
+}
+
+void GUILib::SceneManager::coalesceMotion(SDL_Event& e)
+{
+    if (!canCoalesceMotion()) return;
+
+    // Only the motions right behind, a click in between still has to see the pointer where it was
+    SDL_Event next;
+    while (SDL_PeepEvents(&next, 1, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT) == 1 &&
+        next.type == SDL_MOUSEMOTION && next.motion.which == e.motion.which && next.motion.windowID == e.motion.windowID) {
+        // Events only get added behind, the motion peeked is still the first one
+        if (SDL_PeepEvents(&next, 1, SDL_GETEVENT, SDL_MOUSEMOTION, SDL_MOUSEMOTION) != 1) break;
+
+        next.motion.xrel += e.motion.xrel;
+        next.motion.yrel += e.motion.yrel;
+        e = next;
+        frameStats.coalescedMotions++;
     }
 }
 
+bool GUILib::SceneManager::canCoalesceMotion() const
+{
+    if (!motionCoalescing) return false;
+    if (const auto holder = captured.lock(); holder && holder->needsEveryMotion()) return false;
+
+    // The objects the last motion went to, the pointer mostly stays over them
+    return std::none_of(hoverChain.begin(), hoverChain.end(), [](const std::weak_ptr<GuiObject>& weak) {
+        const auto obj = weak.lock();
+        return obj && obj->needsEveryMotion();
+    });
+}
+
+void GUILib::SceneManager::setMotionCoalescing(bool value)
+{
+    motionCoalescing = value;
+}
+
+bool GUILib::SceneManager::isMotionCoalescing() const
+{
+    return motionCoalescing;
+}
+
+void GUILib::SceneManager::dispatchRunEvent(const SDL_Event& e, const RunOptions& options)
+{
+    if (e.type == SDL_QUIT) running = false;
+    if (options.onEvent) options.onEvent(e);
+    handleEvent(e);
+}
+
+void GUILib::SceneManager::recordFrame(double frameMs, double workMs)
+{
+    // Averaged over roughly the last 20 frames
+    constexpr double WEIGHT = 0.05;
+    const bool first = frameStats.renderedFrames + frameStats.skippedFrames == 1;
+
+    frameStats.lastFrameMs = frameMs;
+    frameStats.lastWorkMs = workMs;
+    frameStats.averageFrameMs = first ? frameMs : frameStats.averageFrameMs + (frameMs - frameStats.averageFrameMs) * WEIGHT;
+    frameStats.averageWorkMs = first ? workMs : frameStats.averageWorkMs + (workMs - frameStats.averageWorkMs) * WEIGHT;
+    frameStats.worstFrameMs = std::max(frameStats.worstFrameMs, frameMs);
+}
+
 void GUILib::SceneManager::clear(std::shared_ptr<GuiObject> obj) {
     auto it = std::remove(objects.begin(), objects.end(), obj);
     if (it != objects.end()) {
         objects.erase(it, objects.end());
     }
+    // Keystrokes must not keep going to an object that left the scene
+    if (const auto target = focus.getFocused(); target && obj) {
+        const auto& store = Reserved::LayoutStore::get();
+        if (store.getRoot(target->node) == obj->node) focus.setFocus(nullptr);
+    }
+    indexDirty = true;
+    renderDirty = true;
 }
 
 void GUILib::SceneManager::clearAll()
 {
     objects.clear();
+    focus.setFocus(nullptr);
+    indexDirty = true;
+    renderDirty = true;
 }
 
 void GUILib::SceneManager::handleEvent(const SDL_Event& e)  
 { 
+   // Cached textures are lost together with the render targets
+   if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+       Reserved::RenderList::releaseRenderer(ref);
+       Reserved::GlyphAtlas::releaseRenderer(ref);
+       target.reset();
+       GuiObject::invalidateCaches();
+       renderDirty = true;
+   }
+   // Static textures only go away with the device
+   if (e.type == SDL_RENDER_DEVICE_RESET) {
+       Reserved::TextureCache::releaseRenderer(ref);
+       Reserved::ImageAtlas::releaseRenderer(ref);
+   }
+   if (e.type == SDL_WINDOWEVENT) {
+       // A resize is picked up by the next render(), once for the whole burst
+       if (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED || e.window.event == SDL_WINDOWEVENT_RESIZED) {
+           renderDirty = true;
+           return;
+       }
+       // The window may have lost its pixels, run() must not skip the next frame
+       if (e.window.event == SDL_WINDOWEVENT_EXPOSED || e.window.event == SDL_WINDOWEVENT_SHOWN ||
+           e.window.event == SDL_WINDOWEVENT_RESTORED) {
+           renderDirty = true;
+       }
+   }
    objects.erase(std::remove_if(objects.begin(), objects.end(),
        [](const std::shared_ptr<GuiObject>& p) { return p == nullptr; }),
        objects.end());
-   for (auto& obj : objects) {  
-       if (!obj) continue;  
-       obj->handleEvent(e);  
-   }  
+
+   switch (e.type) {
+   case SDL_MOUSEMOTION:
+   case SDL_MOUSEBUTTONDOWN:
+   case SDL_MOUSEBUTTONUP:
+   case SDL_MOUSEWHEEL:
+       dispatchPointerEvent(e);
+       return;
+
+   case SDL_KEYDOWN:
+   case SDL_KEYUP:
+   case SDL_TEXTINPUT:
+   case SDL_TEXTEDITING:
+       focus.dispatch(e, objects);
+       return;
+
+   default:
+       // Rare events nobody is specifically concerned by, everybody gets them
+       for (auto& obj : objects) {  
+           if (!obj) continue;  
+           obj->handleEvent(e);  
+       }  
+   }
 }
 
+void GUILib::SceneManager::refreshIndex()
+{
+    // Between frames the size of the last one is still the one objects are laid out against
+    if (outputSize.x == 0 && outputSize.y == 0) SDL_GetRendererOutputSize(ref, &outputSize.x, &outputSize.y);
+
+    // Objects moved since the last frame report their rect to the index once laid out
+    const auto& store = Reserved::LayoutStore::get();
+    for (const auto& obj : objects) {
+        if (obj && store.needsLayout(obj->node)) obj->updateLayout();
+    }
 
+    const SDL_Point area = index.getArea();
+    if (!indexDirty && !index.isStale() && area.x == outputSize.x && area.y == outputSize.y) {
+        // Only objects moved, the ones laid out elsewhere were never reported to this index
+        index.update();
+        return;
+    }
+
+    index.rebuild(objects, outputSize);
+    indexDirty = false;
+}
+
+std::shared_ptr<GUILib::GuiObject> GUILib::SceneManager::hitTest(const SDL_Point& point)
+{
+    refreshIndex();
+    GuiObject* obj = index.query(point);
+    return obj ? obj->shared_from_this() : nullptr;
+}
+
+void GUILib::SceneManager::buildRouteChain(const std::shared_ptr<GuiObject>& target)
+{
+    routeChain.clear();
+    for (auto current = target; current; current = current->getParent().lock()) {
+        routeChain.push_back(current);
+    }
+}
+
+void GUILib::SceneManager::dispatchPointerEvent(const SDL_Event& e)
+{
+    // Wheel events don't carry the pointer position in every SDL version, use the last known one
+    Reserved::getEventPointer(e, pointer);
+
+    std::shared_ptr<GuiObject> target = captured.lock();
+    if (!target || e.type == SDL_MOUSEBUTTONDOWN || e.type == SDL_MOUSEWHEEL) {
+        target = hitTest(pointer);
+    }
+
+    buildRouteChain(target);
+
+    if (e.type == SDL_MOUSEMOTION) {
+        // Objects left by the pointer still get the motion, so they can drop their hover state
+        for (const auto& weak : hoverChain) {
+            const auto obj = weak.lock();
+            if (!obj || std::find(routeChain.begin(), routeChain.end(), obj) != routeChain.end()) continue;
+            if (obj->isActive() && obj->isVisible()) obj->processEvent(e);
+        }
+        hoverChain.assign(routeChain.begin(), routeChain.end());
+    }
+    else if (e.type == SDL_MOUSEBUTTONDOWN) {
+        captured = target;
+
+        std::shared_ptr<GuiObject> newFocus;
+        for (const auto& obj : routeChain) {
+            if (obj->isFocusable()) {
+                newFocus = obj;
+                break;
+            }
+        }
+        setFocus(newFocus);
+    }
+
+    // Bubble up, the target first
+    for (const auto& obj : routeChain) {
+        if (obj->isActive() && obj->isVisible()) obj->processEvent(e);
+    }
+
+    if (e.type == SDL_MOUSEBUTTONUP) {
+        captured.reset();
+    }
+}
+
+void GUILib::SceneManager::setFocus(const std::shared_ptr<GuiObject>& obj)
+{
+    focus.setFocus(obj);
+}
+
+std::shared_ptr<GUILib::GuiObject> GUILib::SceneManager::getFocused() const
+{
+    return focus.getFocused();
+}
+
+std::shared_ptr<GUILib::GuiObject> GUILib::SceneManager::moveFocus(bool backwards)
+{
+    return focus.moveFocus(objects, backwards);
+}
+
+GUILib::FocusManager& GUILib::SceneManager::getFocusManager()
+{
+    return focus;
+}
 
 GUILib::SceneManager::~SceneManager() {
     objects.clear();
@@ -45,7 +509,10 @@ GUILib::SceneManager::~SceneManager() {
 
 void GUILib::SceneManager::updateRenderer(SDL_Renderer* r)
 {
+    target.reset();
     ref = r;
+    indexDirty = true;
+    renderDirty = true;
 }
 
 void GUILib::SceneManager::initialize(SDL_Renderer* r) const
@@ -1,4 +1,5 @@
 #include "frame.h"
+#include "renderList.h"
 
 using namespace GUILib::Reserved;
 
@@ -29,6 +30,7 @@ GUILib::ScrollingFrame::ScrollingFrame() :
 
 void GUILib::ScrollingFrame::setContentSize(const UIUnit& newSize)
 {
+    const UIUnit size = getSize();
     if (newSize.isUsingScale == size.isUsingScale) {
         contentSize.sizeX = std::max(newSize.sizeX, size.sizeX);
         contentSize.sizeY = std::max(newSize.sizeY, size.sizeY);
@@ -42,56 +44,122 @@ void GUILib::ScrollingFrame::setContentSize(const UIUnit& newSize)
     // Holy shit
     contentSize.isUsingScale = size.isUsingScale;
     updateScrollbars();
+    invalidateRender();
 }
 
 void GUILib::ScrollingFrame::render()
 {
+    update(ref);
     if (!shouldRender()) return;
 
-    Frame::render();  // Render base frame
-
-    shouldRenderChildren = false;
+    renderBox();  // Render base frame, the children are rendered clipped below
 
     const SDL_Rect clipRect = getRect();
 
     const SDL_Point absContentSize = contentSize.getAbsoluteSize({clipRect.w, clipRect.h});
 
-    SDL_RenderSetClipRect(ref, &objRect);
+    if (shouldRenderChildren) {
+        updateVisibleChildren(clipRect);
 
-    for (const auto& child : children) {
-        child->render();
-        auto childRect = child->getRect();
-        child->setActive(SDL_HasIntersection(&objRect, &childRect));
-    }
+        auto& renderList = Reserved::RenderList::get(ref);
+        renderList.pushClip(objRect);
 
-    SDL_RenderSetClipRect(ref, nullptr);
+        // Children outside the viewport are skipped entirely, the clip rect would discard them anyway
+        for (const size_t index : visibleChildren) {
+            children[index]->draw();
+        }
+
+        renderList.popClip();
+    }
 
     updateScrollbars();
 
     renderScrollbars(absContentSize, clipRect);
 }
 
+void GUILib::ScrollingFrame::refreshChildExtents(const SDL_Rect& rect)
+{
+    if (indexedGeometryRevision == childrenGeometryRevision &&
+        indexedSize.x == rect.w && indexedSize.y == rect.h) return;
+
+    indexedGeometryRevision = childrenGeometryRevision;
+    indexedSize = { rect.w, rect.h };
+
+    childExtents.clear();
+    for (size_t i = 0; i < children.size(); ++i) {
+        const auto& child = children[i];
+        if (!child) continue;
+
+        // Read from the position and size, the children out of the viewport aren't laid out for it
+        const SDL_Rect childRect = getContentRect(*child);
+        childExtents.push_back({ childRect.y, childRect.y + childRect.h, childRect.x, childRect.x + childRect.w, i, child.get() });
+    }
+
+    std::sort(childExtents.begin(), childExtents.end(),
+        [](const ChildExtent& a, const ChildExtent& b) { return a.top < b.top; });
+
+    maxBottoms.resize(childExtents.size());
+    int maxBottom = std::numeric_limits<int>::min();
+    for (size_t i = 0; i < childExtents.size(); ++i) {
+        maxBottom = std::max(maxBottom, childExtents[i].bottom);
+        maxBottoms[i] = maxBottom;
+    }
+}
+
+bool GUILib::ScrollingFrame::collectVisibleChildren(const SDL_Rect& rect)
+{
+    visibleChildren.clear();
+
+    // The viewport in content coordinates, a pixel wider on each side for the rounding of fractional layouts
+    const int viewTop = scrollY - 1, viewBottom = scrollY + rect.h + 1;
+    const int viewLeft = scrollX - 1, viewRight = scrollX + rect.w + 1;
+
+    // Every child before this one ends above the viewport
+    const auto first = std::upper_bound(maxBottoms.begin(), maxBottoms.end(), viewTop) - maxBottoms.begin();
+
+    for (size_t i = static_cast<size_t>(first); i < childExtents.size(); ++i) {
+        const ChildExtent& extent = childExtents[i];
+        if (extent.top >= viewBottom) break;
+        if (extent.bottom <= viewTop || extent.right <= viewLeft || extent.left >= viewRight) continue;
+
+        if (extent.index >= children.size() || children[extent.index].get() != extent.object) return false;
+        visibleChildren.push_back(extent.index);
+    }
+
+    // Back to the order of the children, which is the drawing order
+    std::sort(visibleChildren.begin(), visibleChildren.end());
+    return true;
+}
+
+void GUILib::ScrollingFrame::updateVisibleChildren(const SDL_Rect& rect)
+{
+    refreshChildExtents(rect);
+    if (!collectVisibleChildren(rect)) {
+        // Some child was replaced without going through setParent()
+        indexedSize = { -1, -1 };
+        refreshChildExtents(rect);
+        collectVisibleChildren(rect);
+    }
+}
+
+void GUILib::ScrollingFrame::updateChildrenLayout()
+{
+    updateVisibleChildren(getRect());
+
+    for (const size_t index : visibleChildren) {
+        children[index]->updateLayout();
+    }
+}
+
 void GUILib::ScrollingFrame::renderScrollbars(const SDL_Point& absContentSize, const SDL_Rect& rect)
 {
-    SDL_SetRenderDrawColor(ref,
-        scrollingBarColor.r,
-        scrollingBarColor.g,
-        scrollingBarColor.b,
-        scrollingBarColor.a
-    );  // Dark gray scrollbars (by default)
+    auto& renderList = Reserved::RenderList::get(ref);
     if (showScrollbarX) {
         if (const int maxScrollX = absContentSize.x - rect.w; maxScrollX > 0) {
             const int scrollbarX = rect.x + (scrollX * (rect.w - scrollbarWidth)) / maxScrollX;
 
             handleRectX = {scrollbarX, rect.y + rect.h - 8, scrollbarWidth, 8};
-            SDL_SetRenderDrawColor(
-                ref,
-                scrollingBarColor.r,
-                scrollingBarColor.g,
-                scrollingBarColor.b,
-                scrollingBarColor.a
-            );
-            SDL_RenderFillRect(ref, &handleRectX);
+            renderList.fill(scrollingBarColor, handleRectX);
         }
     }
 
@@ -103,14 +171,7 @@ void GUILib::ScrollingFrame::renderScrollbars(const SDL_Point& absContentSize, c
             int scrollbarY = rect.y + (scrollY * (rect.h - scrollbarHeight)) / maxScrollY;
 
             handleRectY = {rect.x + rect.w - 8, scrollbarY, 8, scrollbarHeight};
-            SDL_SetRenderDrawColor(
-                ref,
-                scrollingBarColor.r,
-                scrollingBarColor.g,
-                scrollingBarColor.b,
-                scrollingBarColor.a
-            );
-            SDL_RenderFillRect(ref, &handleRectY);
+            renderList.fill(scrollingBarColor, handleRectY);
         }
     }
 }
@@ -126,26 +187,72 @@ void GUILib::ScrollingFrame::scroll(int deltaX, int deltaY) {
     const SDL_Rect rect = getRect();
     const auto [absContentSizeX, absContentSizeY] = contentSize.getAbsoluteSize({ rect.w, rect.h });
 
+    const int oldScrollX = scrollX, oldScrollY = scrollY;
+
     if (showScrollbarX) {
         scrollX = static_cast<int>(clamp(scrollX + deltaX, 0, absContentSizeX - rect.w));
     }
     if (showScrollbarY) {
         scrollY = static_cast<int>(clamp(scrollY + deltaY, 0, absContentSizeY - rect.h));
     }
+
+    if (scrollX != oldScrollX || scrollY != oldScrollY) {
+        invalidateContentOffset();
+        invalidateRender();
+        // The children moved under the pointer, even if none of them is laid out before the next hit test
+        invalidateTree();
+    }
 }
 
-void GUILib::ScrollingFrame::handleEvent(const SDL_Event& event)
+SDL_Point GUILib::ScrollingFrame::getContentOffset() const
+{
+    return { scrollX, scrollY };
+}
+
+bool GUILib::ScrollingFrame::getTweenValue(TweenType type, double* values) const
+{
+    if (type != TweenType::SCROLL) return Frame::getTweenValue(type, values);
+    values[0] = scrollX;
+    values[1] = scrollY;
+    return true;
+}
+
+void GUILib::ScrollingFrame::setTweenValue(TweenType type, const double* values)
+{
+    if (type != TweenType::SCROLL) {
+        Frame::setTweenValue(type, values);
+        return;
+    }
+    // Clamped to the content like the wheel and the scrollbars
+    scroll(static_cast<int>(std::lround(values[0])) - scrollX, static_cast<int>(std::lround(values[1])) - scrollY);
+}
+
+bool GUILib::ScrollingFrame::clipsChildren() const
+{
+    return true;
+}
+
+void GUILib::ScrollingFrame::forEachChildInView(const std::function<void(GuiObject*)>& callback)
+{
+    // Children out of the viewport may be out of date since the last scroll, they stay that way
+    updateVisibleChildren(getRect());
+    for (const size_t index : visibleChildren) {
+        callback(children[index].get());
+    }
+}
+
+void GUILib::ScrollingFrame::processEvent(const SDL_Event& event)
 {
     if (!isActive()) return;
 
-	GuiObject::handleEvent(event);
+	GuiObject::processEvent(event);
 
     const SDL_Rect rect = getRect();
 
-	int mouseX,
-        mouseY;
-
-    SDL_GetMouseState(&mouseX, &mouseY);
+    // The position the event happened at, the pointer may have moved on since it was queued
+    SDL_Point pointer;
+    if (!Reserved::getEventPointer(event, pointer)) return;
+    const auto [mouseX, mouseY] = pointer;
 
     if (event.type == SDL_MOUSEWHEEL) {
         if (isPointInRect({ mouseX, mouseY }, rect))
@@ -180,7 +287,7 @@ void GUILib::ScrollingFrame::handleEvent(const SDL_Event& event)
 }
 
 SDL_Color GUILib::ScrollingFrame::getScrollbarColor() const { return scrollingBarColor; }
-void GUILib::ScrollingFrame::setScrollbarColor(SDL_Color color) { scrollingBarColor = color; }
+void GUILib::ScrollingFrame::setScrollbarColor(SDL_Color color) { scrollingBarColor = color; invalidateRender(); }
 
 void GUILib::ScrollingFrame::setScrollingSpeed(int speed) {
     scrollingSpeed = speed;
@@ -210,4 +317,5 @@ int GUILib::ScrollingFrame::getScrollbarWidth() const {
 
 void GUILib::ScrollingFrame::setScrollbarWidth(const int& val) {
     scrollbarWidth = val;
+    invalidateRender();
 }
\ No newline at end of file
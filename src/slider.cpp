@@ -1,5 +1,6 @@
 #include "slider.h"
 #include "guiobject.h"
+#include "renderList.h"
 
 using namespace GUILib::Reserved;
 
@@ -15,6 +16,7 @@ void GUILib::Slider::moveHandle(int delta)
             offsetY = static_cast<int>(clamp(offsetY + delta, 0, rect.h));
             break;
     }
+    invalidateRender();
 }
 
 GUILib::Slider::Slider(
@@ -49,20 +51,14 @@ void GUILib::Slider::render()
 void GUILib::Slider::renderHandle()
 {
     const SDL_Rect rect = getRect();
-    SDL_SetRenderDrawColor(ref, handleColor.r, handleColor.g, handleColor.b, handleColor.a);
+    auto& renderList = Reserved::RenderList::get(ref);
     switch (direction) {
         case DragDirection::HORIZONTAL: {
             const int maxScrollX = rect.w;
             if (maxScrollX <= 0) break;
             const int scrollbarX = rect.x + (offsetX * (rect.w - handleSize)) / maxScrollX;
             handleRect = {scrollbarX, rect.y, handleSize, rect.h};
-            SDL_SetRenderDrawColor(ref,
-                handleColor.r,
-                handleColor.r,
-                handleColor.r,
-                handleColor.a
-            );
-            SDL_RenderFillRect(ref, &handleRect);
+            renderList.fill(handleColor, handleRect);
             break;
         }
 
@@ -71,22 +67,15 @@ void GUILib::Slider::renderHandle()
             if (maxScrollY <= 0) break;
             const int scrollbarY = rect.y + (offsetY * (rect.h - handleSize)) / maxScrollY;
             handleRect = {rect.x, scrollbarY, rect.w, handleSize};
-            SDL_SetRenderDrawColor(
-                ref,
-                handleColor.r,
-                handleColor.r,
-                handleColor.r,
-                handleColor.a
-            );
-            SDL_RenderFillRect(ref, &handleRect);
+            renderList.fill(handleColor, handleRect);
             break;
         }
     }
 }
 
-void GUILib::Slider::handleEvent(const SDL_Event& event)
+void GUILib::Slider::processEvent(const SDL_Event& event)
 {
-    GuiObject::handleEvent(event);
+    GuiObject::processEvent(event);
     if (!isActive()) return;
     if (event.type == SDL_MOUSEBUTTONDOWN) {
         const int mouseX = event.button.x;
@@ -126,6 +115,7 @@ int GUILib::Slider::getHandleSize() const
 void GUILib::Slider::setHandleSize(int s)
 {
     handleSize = s;
+    invalidateRender();
 }
 
 SDL_Color GUILib::Slider::getHandleColor() const
@@ -136,6 +126,7 @@ SDL_Color GUILib::Slider::getHandleColor() const
 void GUILib::Slider::setHandleColor(SDL_Color color)
 {
     handleColor = color;
+    invalidateRender();
 }
 
 GUILib::DragDirection GUILib::Slider::getDirection() const
@@ -146,4 +137,5 @@ GUILib::DragDirection GUILib::Slider::getDirection() const
 void GUILib::Slider::setDirection(DragDirection dir)
 {
     direction = dir;
+    invalidateRender();
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "spatialIndex.h"
+#include "guiobject.h"
+
+using namespace GUILib::Reserved;
+
+SpatialIndex::SpatialIndex(int cellSize) : cellSize(std::max(cellSize, 1))
+{
+    instances.push_back(this);
+}
+
+SpatialIndex::SpatialIndex(const SpatialIndex& other)
+    : cellSize(other.cellSize), columns(other.columns), rows(other.rows), area(other.area), stale(other.stale),
+      entries(other.entries), entryOf(other.entryOf), cells(other.cells), moved(other.moved)
+{
+    instances.push_back(this);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    instances.erase(std::remove(instances.begin(), instances.end(), this), instances.end());
+}
+
+void SpatialIndex::clear()
+{
+    entries.clear();
+    entryOf.clear();
+    cells.clear();
+    moved.clear();
+    columns = rows = 0;
+    area = {};
+    stale = true;
+}
+
+size_t SpatialIndex::size() const
+{
+    return entries.size();
+}
+
+bool SpatialIndex::isStale() const
+{
+    return stale;
+}
+
+SDL_Point SpatialIndex::getArea() const
+{
+    return area;
+}
+
+const uint32_t* SpatialIndex::find(const GuiObject* object) const
+{
+    const auto it = entryOf.find(object);
+    return it != entryOf.end() ? &it->second : nullptr;
+}
+
+void SpatialIndex::objectMoved(const GuiObject* object, const SDL_Rect& rect)
+{
+    for (SpatialIndex* index : instances) {
+        if (index->stale) continue;
+
+        if (const uint32_t* found = index->find(object)) {
+            Entry& entry = index->entries[*found];
+            entry.bounds = rect;
+            // The clip of its descendants changed with it
+            if (entry.childrenIndexed && object->clipsChildren()) {
+                index->stale = true;
+                continue;
+            }
+            if (!entry.moved) {
+                entry.moved = true;
+                index->moved.push_back(*found);
+            }
+            // Past some point rebuilding is cheaper than moving them one by one
+            if (index->moved.size() > index->entries.size() / 2 + 16) index->stale = true;
+        }
+        else {
+            // A child that wasn't in view may be now
+            const auto parent = object->getParent().lock();
+            const uint32_t* parentEntry = parent ? index->find(parent.get()) : nullptr;
+            if (parentEntry && index->entries[*parentEntry].childrenIndexed) index->stale = true;
+        }
+    }
+}
+
+void SpatialIndex::objectChanged(const GuiObject* object)
+{
+    const auto parent = object->getParent().lock();
+    for (SpatialIndex* index : instances) {
+        if (index->stale) continue;
+        if (index->find(object) || (parent && index->find(parent.get()))) index->stale = true;
+    }
+}
+
+void SpatialIndex::collect(GuiObject* object, const SDL_Rect& clip)
+{
+    if (!object) return;
+
+    const uint32_t entry = static_cast<uint32_t>(entries.size());
+    entryOf[object] = entry;
+    entries.push_back({ object, {}, clip, {}, false, false });
+
+    // Objects that don't receive events hide their whole subtree, same as handleEvent does.
+    // They are still kept, to know which index to make stale when they come back
+    if (!object->isVisible() || !object->isActive()) return;
+
+    const SDL_Rect rect = object->getRect();
+    entries[entry].bounds = rect;
+    if (!SDL_IntersectRect(&rect, &clip, &entries[entry].rect)) entries[entry].rect = {};
+
+    if (!object->getChildrenRenderingState()) return;
+
+    SDL_Rect childClip = clip;
+    if (object->clipsChildren() && !SDL_IntersectRect(&rect, &clip, &childClip)) {
+        return;
+    }
+    entries[entry].childrenIndexed = true;
+
+    // Containers may leave out the children out of sight, so they aren't laid out just to be indexed
+    object->forEachChildInView([&](GuiObject* child) { collect(child, childClip); });
+}
+
+bool SpatialIndex::cellRange(const SDL_Rect& rect, int& x0, int& y0, int& x1, int& y1) const
+{
+    if (columns == 0 || rows == 0 || rect.w <= 0 || rect.h <= 0) return false;
+
+    x0 = std::max(rect.x / cellSize, 0);
+    y0 = std::max(rect.y / cellSize, 0);
+    x1 = std::min((rect.x + rect.w - 1) / cellSize, columns - 1);
+    y1 = std::min((rect.y + rect.h - 1) / cellSize, rows - 1);
+
+    return x0 <= x1 && y0 <= y1;
+}
+
+void SpatialIndex::place(uint32_t entry, bool add)
+{
+    int x0, y0, x1, y1;
+    if (!cellRange(entries[entry].rect, x0, y0, x1, y1)) return;
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            auto& cell = cells[static_cast<size_t>(y) * columns + x];
+            // Kept sorted, so the last match of a query stays the topmost object
+            const auto it = std::lower_bound(cell.begin(), cell.end(), entry);
+            if (add) cell.insert(it, entry);
+            else if (it != cell.end() && *it == entry) cell.erase(it);
+        }
+    }
+}
+
+void SpatialIndex::rebuild(const std::vector<std::shared_ptr<GuiObject>>& roots, const SDL_Point& area)
+{
+    entries.clear();
+    entryOf.clear();
+    moved.clear();
+
+    this->area = area;
+    columns = std::max((area.x + cellSize - 1) / cellSize, 0);
+    rows = std::max((area.y + cellSize - 1) / cellSize, 0);
+
+    // Objects laid out while collecting are read as they are visited
+    stale = true;
+    const SDL_Rect bounds { 0, 0, area.x, area.y };
+    for (const auto& root : roots) {
+        collect(root.get(), bounds);
+    }
+
+    cells.resize(static_cast<size_t>(columns) * rows);
+    for (auto& cell : cells) cell.clear();
+
+    // Visited in rendering order, the cells come out sorted
+    int x0, y0, x1, y1;
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        if (!cellRange(entries[i].rect, x0, y0, x1, y1)) continue;
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                cells[static_cast<size_t>(y) * columns + x].push_back(i);
+            }
+        }
+    }
+    stale = false;
+}
+
+void SpatialIndex::update()
+{
+    if (stale) return;
+
+    for (const uint32_t i : moved) {
+        Entry& entry = entries[i];
+        entry.moved = false;
+        if (!entry.object->isVisible() || !entry.object->isActive()) continue;
+
+        SDL_Rect rect;
+        if (!SDL_IntersectRect(&entry.bounds, &entry.clip, &rect)) rect = {};
+        if (SDL_RectEquals(&rect, &entry.rect)) continue;
+
+        place(i, false);
+        entry.rect = rect;
+        place(i, true);
+    }
+    moved.clear();
+}
+
+GUILib::GuiObject* SpatialIndex::query(const SDL_Point& point) const
+{
+    if (point.x < 0 || point.y < 0) return nullptr;
+
+    const int x = point.x / cellSize, y = point.y / cellSize;
+    if (x >= columns || y >= rows) return nullptr;
+
+    const auto& cell = cells[static_cast<size_t>(y) * columns + x];
+
+    // Entries are stored in rendering order, the last match is the topmost one
+    for (auto it = cell.rbegin(); it != cell.rend(); ++it) {
+        const Entry& entry = entries[*it];
+        if (SDL_PointInRect(&point, &entry.rect)) {
+            return entry.object;
+        }
+    }
+    return nullptr;
+}
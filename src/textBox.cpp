@@ -1,4 +1,6 @@
 #include "textBox.h"
+#include "renderList.h"
+#include "glyphAtlas.h"
 
 int GUILib::TextBox::lineHeight() const
 {
@@ -10,150 +12,197 @@ std::vector<std::string> GUILib::TextBox::splitTextIntoLines(
     const std::string& str,
     const int& maxWidth) const
 {
-    std::vector<std::string> outLines;
-    std::string currentLine;
-    std::string word;
+    Reserved::TextWrapper splitter;
+    splitter.update(str, textFont, maxWidth);
+    return splitter.getLines();
+}
 
-    for (const char& c : str) {
-        // cut the line
-        if (c == ' ' || c == '\n') {
-            // line measurement
-            int wordWidth = 0, wordHeight = 0;
+void GUILib::TextBox::render()
+{
+    update(ref);
+    if (!shouldRender()) return;
 
-            TTF_SizeText(textFont, (currentLine + word).c_str(), &wordWidth, &wordHeight);
+    const SDL_Point offsetPoint = getPivotOffsetPoint();
 
-            if (wordWidth > maxWidth) {
-                // wrap the text
-                outLines.push_back(currentLine);
-                currentLine = word;
-            }
-            else {
-                currentLine += word;
-            }
+    // Rotated box? maybe later, rotation should be hidden in the meantime
+    Reserved::renderSolidBox(ref, boxColor, objRect, getRotation(), &offsetPoint);
 
-            if (c == '\n') {
-                outLines.push_back(currentLine);
-                currentLine.clear();
-            }
-            else {
-                currentLine += ' ';
-            }
-            word.clear();
-        }
-        else {
-            word += c;
-        }
+    if (!textFont) {
+        GuiObject::render();
+        return;
     }
 
-    // last line
-    if (!currentLine.empty() || !word.empty()) {
-        outLines.push_back(currentLine + word);
-    }
-    return outLines;
+    // An empty text still gets its (empty) line laid out, the caret of editable boxes goes there
+    refreshTextLayout();
+    // properly implement rotated text rendering (later)
+    renderText();
+
+    GuiObject::render();
 }
 
-void GUILib::TextBox::render()
+bool GUILib::TextBox::TextLayoutKey::operator==(const TextLayoutKey& other) const
 {
-    if (!shouldRender()) return;
+    return textRevision == other.textRevision && font == other.font &&
+           width == other.width && height == other.height &&
+           xAlign == other.xAlign && yAlign == other.yAlign;
+}
 
-    constexpr int padding = 5;
-    const int maxWidth = objRect.w - padding * 2;
+bool GUILib::TextBox::GlyphQuadKey::operator==(const GlyphQuadKey& other) const
+{
+    return atlasId == other.atlasId && x == other.x && y == other.y && color == other.color &&
+           view.x == other.view.x && view.y == other.view.y && view.w == other.view.w && view.h == other.view.h;
+}
 
-    // Shouldn't cause a problem
-    const int totalHeight = static_cast<int>(lines.size()) * lineHeight();
+bool GUILib::TextBox::GlyphQuadKey::operator!=(const GlyphQuadKey& other) const
+{
+    return !(*this == other);
+}
 
-    // takes ref (the renderer)
-    const Reserved::TextureType boxTexture = Reserved::createSolidBoxTexture(ref, boxColor, objRect.w, objRect.h);
+void GUILib::TextBox::invalidateText()
+{
+    textRevision++;
+    invalidateRender();
+}
 
-    const SDL_Point offsetPoint = getPivotOffsetPoint();
+void GUILib::TextBox::wrapText(int maxWidth)
+{
+    wrapper.update(text, textFont, maxWidth);
+}
 
-    // Rotated box? maybe later, rotation should be hidden in the meantime
-    SDL_RenderCopyEx(ref, boxTexture.get(), nullptr, &objRect, degreeRotation, &offsetPoint, SDL_FLIP_NONE);
+size_t GUILib::TextBox::textLength() const
+{
+    return text.size();
+}
 
-    // checking whether the text is empty or not to prevent problematic stuff
-    if (text.empty() || !textFont) {
-        GuiObject::render();
-        return;
-    }
-    
-    lines = splitTextIntoLines(text, maxWidth); // For wrapping (manual handling)
+void GUILib::TextBox::refreshTextLayout()
+{
+    const TextLayoutKey key { textRevision, textFont, objRect.w, objRect.h, xAlign, yAlign };
+    if (textLayoutKey == key) return;
+    textLayoutKey = key;
+    glyphQuadKey.reset();
+
+    constexpr int padding = 5;
+    const int maxWidth = objRect.w - padding * 2;
+
+    wrapText(maxWidth); // For wrapping (manual handling)
+    const auto& lines = wrapper.getLines();
+    const auto& widths = wrapper.getWidths();
+
+    const int height = Reserved::FontMetrics::get(textFont).height();
+    const int totalHeight = static_cast<int>(lines.size()) * height;
 
-	int startY = objRect.y;
+    // Positions are relative to the box, so moving it doesn't need a new layout
+    int startY = 0;
     switch (yAlign) {
     case VerticalTextAlign::UP:
-        startY = objRect.y + padding;
+        startY = padding;
         break;
     case VerticalTextAlign::CENTER:
-        startY = objRect.y + (objRect.h - totalHeight) / 2;
+        startY = (objRect.h - totalHeight) / 2;
         break;
     case VerticalTextAlign::BOTTOM:
-        startY = objRect.y + (objRect.h - totalHeight) - padding;
+        startY = (objRect.h - totalHeight) - padding;
         break;
     }
 
-    int offsetY = 0;
-    // properly implement rotated text rendering (later)
     renderedLines.clear();
+    renderedLines.reserve(lines.size());
 
-    for (const auto& line : lines) {
-        int textWidth = 0, textHeight = 0;
-        if (!line.empty()) {
-            TTF_SizeText(textFont, line.c_str(), &textWidth, &textHeight);
-        }
-        else {
-            // For blank lines, use a minimal width and the font's height
-            textWidth = 1;
-            textHeight = lineHeight();
-        }
+    int offsetY = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const auto& line = lines[i];
+        // For blank lines, use a minimal width
+        const int textWidth = line.empty() ? 1 : widths[i];
 
-        int startX = objRect.x;
+        int startX = 0;
         switch (xAlign) {
         case HorizontalTextAlign::LEFT:
-            startX = objRect.x + padding;
+            startX = padding;
             break;
         case HorizontalTextAlign::CENTER:
-            startX = objRect.x + (maxWidth - textWidth) / 2 + padding;
+            startX = (maxWidth - textWidth) / 2 + padding;
             break;
         case HorizontalTextAlign::RIGHT:
-            startX = objRect.x + maxWidth - textWidth - padding;
+            startX = maxWidth - textWidth - padding;
             break;
         }
 
-        const SDL_Point linePos = { startX, startY + offsetY };
-        renderedLines.push_back({ line, linePos });
+        renderedLines.push_back({ textWidth, { startX, startY + offsetY } });
+        offsetY += height;
+    }
+}
 
-        SDL_Surface* textSurface = nullptr;
-        if (!line.empty()) {
-            textSurface = TTF_RenderUTF8_Blended(textFont, line.c_str(), textColor);
-        }
-        else {
-            // Create a blank (transparent) surface for empty lines
-            textSurface = SDL_CreateRGBSurfaceWithFormat(0, textWidth, textHeight, 32, SDL_PIXELFORMAT_RGBA32);
-            SDL_FillRect(textSurface, nullptr, SDL_MapRGBA(textSurface->format, 0, 0, 0, 0));
+void GUILib::TextBox::renderText()
+{
+    auto& atlas = Reserved::GlyphAtlas::get(ref, textFont);
+
+    // Only lines in the visible area get quads, long texts are mostly out of it
+    SDL_Rect view {};
+    if (SDL_RenderIsClipEnabled(ref)) {
+        SDL_RenderGetClipRect(ref, &view);
+    }
+    else {
+        SDL_GetRendererOutputSize(ref, &view.w, &view.h);
+    }
+
+    const GlyphQuadKey key {
+        atlas.getId(), objRect.x, objRect.y,
+        static_cast<Uint32>(textColor.r) << 24 |
+        static_cast<Uint32>(textColor.g) << 16 |
+        static_cast<Uint32>(textColor.b) << 8 |
+        static_cast<Uint32>(textColor.a),
+        view
+    };
+
+    if (glyphQuadKey != key) {
+        glyphQuadKey = key;
+        for (auto& vertices : glyphQuads) vertices.clear();
+
+        auto& metrics = Reserved::FontMetrics::get(textFont);
+        const auto& lines = wrapper.getLines();
+        const int height = metrics.height();
+
+        // Lines are evenly spaced, the visible ones are found without walking the others
+        size_t first = 0, last = renderedLines.size();
+        if (!renderedLines.empty() && height > 0) {
+            const int top = objRect.y + renderedLines.front().position.y;
+            const int firstVisible = (view.y - top) / height - 1;
+            const int lastVisible = (view.y + view.h - top) / height + 1;
+            first = static_cast<size_t>(std::clamp(firstVisible, 0, static_cast<int>(renderedLines.size())));
+            last = static_cast<size_t>(std::clamp(lastVisible, 0, static_cast<int>(renderedLines.size())));
         }
-        if (!textSurface) continue;
 
-        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(ref, textSurface);
-        SDL_Rect destRect = { startX, startY + offsetY, textWidth, textHeight };
+        for (size_t line = first; line < last; ++line) {
+            const std::string& lineText = lines[line];
+            const SDL_Point& linePosition = renderedLines[line].position;
 
-        SDL_RenderCopy(ref, textTexture, nullptr, &destRect);
+            float penX = static_cast<float>(objRect.x + linePosition.x);
+            const float y = static_cast<float>(objRect.y + linePosition.y);
 
-        offsetY += textHeight;
-        SDL_FreeSurface(textSurface);
-        SDL_DestroyTexture(textTexture);
+            Uint32 previous = 0;
+            for (size_t i = 0; i < lineText.size();) {
+                const Uint32 codepoint = Reserved::decodeUtf8(lineText, i);
+                penX += static_cast<float>(metrics.kerning(previous, codepoint));
+                Reserved::appendGlyphQuad(glyphQuads, atlas, atlas.glyph(codepoint), penX, y, textColor);
+                penX += static_cast<float>(metrics.advance(codepoint));
+                previous = codepoint;
+            }
+        }
     }
-    GuiObject::render();
+
+    atlas.draw(glyphQuads);
 }
 
 void GUILib::TextBox::updateText(const char* textToUpdate)
 {
-    text = textToUpdate;
+    setText(textToUpdate);
     render();
 }
 
 void GUILib::TextBox::changeFont(TTF_Font*& font)
 {
     textFont = font;
+    invalidateRender();
 }
 
 GUILib::TextBox::TextBox(
@@ -184,6 +233,24 @@ SDL_Color GUILib::TextBox::getBoxColor() const
     return boxColor;
 }
 
+bool GUILib::TextBox::getTweenValue(TweenType type, double* values) const
+{
+    switch (type) {
+    case TweenType::COLOR: Reserved::colorToTween(boxColor, values); return true;
+    case TweenType::TEXT_COLOR: Reserved::colorToTween(textColor, values); return true;
+    default: return GuiObject::getTweenValue(type, values);
+    }
+}
+
+void GUILib::TextBox::setTweenValue(TweenType type, const double* values)
+{
+    switch (type) {
+    case TweenType::COLOR: setBoxColor(Reserved::tweenToColor(values)); break;
+    case TweenType::TEXT_COLOR: setTextColor(Reserved::tweenToColor(values)); break;
+    default: GuiObject::setTweenValue(type, values); break;
+    }
+}
+
 SDL_Color GUILib::TextBox::getTextColor() const
 {
     return textColor;
@@ -197,16 +264,19 @@ std::string GUILib::TextBox::getText() const
 void GUILib::TextBox::setBoxColor(const SDL_Color& color)
 {
     boxColor = color;
+    invalidateRender();
 }
 
 void GUILib::TextBox::setTextColor(const SDL_Color& color)
 {
     textColor = color;
+    invalidateRender();
 }
 
 void GUILib::TextBox::setText(const std::string& str)
 {
     text = str;
+    invalidateText();
 }
 
 GUILib::TextBox& GUILib::TextBox::operator=(const TextBox& other) = default;
@@ -221,7 +291,7 @@ void GUILib::TextBox::setTextAlignment(
 ) {
     xAlign = alignX;
     yAlign = alignY;
-    this->render();
+    invalidateRender();
 }
 
 
@@ -0,0 +1,202 @@
+#include "textBuffer.h"
+
+using namespace GUILib::Reserved;
+
+namespace {
+    constexpr size_t MIN_GAP = 64;
+}
+
+TextBuffer::TextBuffer() : gapStart(0), gapEnd(0), shiftFrom(0), pendingShift(0) {}
+
+size_t TextBuffer::gapLength() const
+{
+    return gapEnd - gapStart;
+}
+
+size_t TextBuffer::size() const
+{
+    return data.size() - gapLength();
+}
+
+bool TextBuffer::empty() const
+{
+    return size() == 0;
+}
+
+char TextBuffer::operator[](size_t position) const
+{
+    return position < gapStart ? data[position] : data[position + gapLength()];
+}
+
+void TextBuffer::moveGap(size_t position)
+{
+    if (position < gapStart) {
+        // Bytes between the position and the gap go after it
+        const size_t count = gapStart - position;
+        std::memmove(data.data() + gapEnd - count, data.data() + position, count);
+        gapStart -= count;
+        gapEnd -= count;
+    }
+    else if (position > gapStart) {
+        const size_t count = position - gapStart;
+        std::memmove(data.data() + gapStart, data.data() + gapEnd, count);
+        gapStart += count;
+        gapEnd += count;
+    }
+}
+
+void TextBuffer::reserveGap(size_t length)
+{
+    if (gapLength() >= length) return;
+
+    const size_t tail = data.size() - gapEnd;
+    const size_t newSize = std::max(data.size() * 2, size() + length + MIN_GAP);
+    data.resize(newSize);
+
+    // Move what follows the gap to the end
+    std::memmove(data.data() + newSize - tail, data.data() + gapEnd, tail);
+    gapEnd = newSize - tail;
+}
+
+size_t TextBuffer::newlineAt(size_t index) const
+{
+    return index >= shiftFrom
+        ? static_cast<size_t>(static_cast<std::ptrdiff_t>(newlines[index]) + pendingShift)
+        : newlines[index];
+}
+
+void TextBuffer::moveShiftBoundary(size_t index)
+{
+    // Only the entries between the old and the new boundary change, edits tend to be close to each other
+    for (; shiftFrom < index; ++shiftFrom) {
+        newlines[shiftFrom] = static_cast<size_t>(static_cast<std::ptrdiff_t>(newlines[shiftFrom]) + pendingShift);
+    }
+    for (; shiftFrom > index; --shiftFrom) {
+        newlines[shiftFrom - 1] = static_cast<size_t>(static_cast<std::ptrdiff_t>(newlines[shiftFrom - 1]) - pendingShift);
+    }
+}
+
+void TextBuffer::insert(size_t position, std::string_view str)
+{
+    if (str.empty()) return;
+    position = std::min(position, size());
+
+    moveGap(position);
+    reserveGap(str.size());
+    std::memcpy(data.data() + gapStart, str.data(), str.size());
+    gapStart += str.size();
+
+    const size_t index = lineOf(position);
+    moveShiftBoundary(index);
+    pendingShift += static_cast<std::ptrdiff_t>(str.size());
+
+    // New entries are stored without the shift, like the ones around them
+    std::vector<size_t> inserted;
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == '\n') {
+            inserted.push_back(static_cast<size_t>(static_cast<std::ptrdiff_t>(position + i) - pendingShift));
+        }
+    }
+    if (!inserted.empty()) {
+        newlines.insert(newlines.begin() + static_cast<std::ptrdiff_t>(index), inserted.begin(), inserted.end());
+    }
+}
+
+void TextBuffer::erase(size_t position, size_t count)
+{
+    if (position >= size()) return;
+    count = std::min(count, size() - position);
+    if (count == 0) return;
+
+    const size_t first = lineOf(position);
+    const size_t last = lineOf(position + count);
+
+    moveGap(position);
+    gapEnd += count;
+
+    moveShiftBoundary(first);
+    newlines.erase(newlines.begin() + static_cast<std::ptrdiff_t>(first), newlines.begin() + static_cast<std::ptrdiff_t>(last));
+    pendingShift -= static_cast<std::ptrdiff_t>(count);
+}
+
+void TextBuffer::assign(std::string_view str)
+{
+    data.assign(str.begin(), str.end());
+    // The gap sits at the end
+    data.resize(str.size() + MIN_GAP);
+    gapStart = str.size();
+    gapEnd = data.size();
+
+    newlines.clear();
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == '\n') newlines.push_back(i);
+    }
+    shiftFrom = newlines.size();
+    pendingShift = 0;
+}
+
+void TextBuffer::clear()
+{
+    assign({});
+}
+
+std::string TextBuffer::substr(size_t position, size_t count) const
+{
+    if (position >= size()) return {};
+    count = std::min(count, size() - position);
+
+    std::string result(count, '\0');
+    const size_t end = position + count;
+
+    // The part before the gap, then the part after it
+    size_t written = 0;
+    if (position < gapStart) {
+        const size_t before = std::min(end, gapStart) - position;
+        std::memcpy(result.data(), data.data() + position, before);
+        written = before;
+    }
+    if (end > gapStart) {
+        const size_t from = std::max(position, gapStart);
+        std::memcpy(result.data() + written, data.data() + from + gapLength(), end - from);
+    }
+    return result;
+}
+
+std::string TextBuffer::toString() const
+{
+    return substr(0, size());
+}
+
+size_t TextBuffer::lineCount() const
+{
+    return newlines.size() + 1;
+}
+
+size_t TextBuffer::lineOf(size_t position) const
+{
+    // The amount of '\n' before the position
+    size_t low = 0, high = newlines.size();
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (newlineAt(middle) < position) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+size_t TextBuffer::lineStart(size_t line) const
+{
+    if (line == 0) return 0;
+    return newlineAt(std::min(line, newlines.size()) - 1) + 1;
+}
+
+size_t TextBuffer::lineEnd(size_t line) const
+{
+    return line < newlines.size() ? newlineAt(line) : size();
+}
+
+std::string TextBuffer::line(size_t line) const
+{
+    const size_t start = lineStart(line);
+    return substr(start, lineEnd(line) - start);
+}
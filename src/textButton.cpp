@@ -1,11 +1,13 @@
 #include "button.h"
 #include "types.h"
+#include "renderList.h"
 
 int GUILib::TextButton::nextId = 0;
 
 void GUILib::TextButton::initialize(SDL_Renderer* renderer)
 {
     GuiObject::initialize(renderer);
+    invalidateRender();
     if (!renderer) {
         return;
     }
@@ -34,6 +36,7 @@ void GUILib::TextButton::initialize(SDL_Renderer* renderer)
 
 void GUILib::TextButton::render()
 {
+    update(ref);
     if (!shouldRender()) return;
 
     // set the color to draw for the button and also set the settings to render the button
@@ -42,10 +45,11 @@ void GUILib::TextButton::render()
     if (!active) {
         drawColor = hoverColor;
     }
-    SDL_SetRenderDrawColor(ref, drawColor.r, drawColor.g, drawColor.b, drawColor.a);
-    SDL_RenderFillRect(ref, &objRect);
+    auto& renderList = Reserved::RenderList::get(ref);
+    renderList.fill(drawColor, objRect);
 
-    if (!textTexture) initialize(ref);
+    // Nothing to create without text, trying again would only record the scene anew
+    if (!textTexture && !text.empty() && textFont) initialize(ref);
 
     if (textTexture) {
         int textWidth = 0, textHeight = 0;
@@ -81,7 +85,7 @@ void GUILib::TextButton::render()
 
         textRect.w = textWidth; textRect.h = textHeight;
 
-        SDL_RenderCopy(ref, textTexture, nullptr, &textRect);
+        renderList.copy(textTexture, { 0, 0, textWidth, textHeight }, textRect);
     }
     GuiObject::render();
 }
@@ -202,10 +206,38 @@ void GUILib::TextButton::setText(const std::string& str)
 
     text = str;
     initialize(ref);
-    trigger("onTextChange", str);
+    onTextChange.fire(str);
 }
 
 std::string GUILib::TextButton::getText() const
 {
     return text;
-}
\ No newline at end of file
+}
+
+GUILib::Reserved::SignalBase* GUILib::TextButton::findSignal(std::string_view eventName)
+{
+    if (eventName == "onTextChange") return &onTextChange;
+    return Button::findSignal(eventName);
+}
+
+bool GUILib::TextButton::getTweenValue(TweenType type, double* values) const
+{
+    switch (type) {
+    case TweenType::COLOR: Reserved::colorToTween(buttonColor, values); return true;
+    case TweenType::TEXT_COLOR: Reserved::colorToTween(textColor, values); return true;
+    default: return Button::getTweenValue(type, values);
+    }
+}
+
+void GUILib::TextButton::setTweenValue(TweenType type, const double* values)
+{
+    switch (type) {
+    case TweenType::COLOR:
+        // The text is drawn again only when its own color changes
+        buttonColor = Reserved::tweenToColor(values);
+        invalidateRender();
+        break;
+    case TweenType::TEXT_COLOR: changeTextColor(Reserved::tweenToColor(values)); break;
+    default: Button::setTweenValue(type, values); break;
+    }
+}
@@ -0,0 +1,250 @@
+#include "textWrap.h"
+#include "glyphAtlas.h"
+
+using namespace GUILib::Reserved;
+
+namespace {
+    /// @brief Replaces count items of target, starting at position, by the items.
+    /// Overlapping slots are move-assigned, so same-sized replacements don't shift the tail.
+    template <typename T>
+    void replaceRange(std::vector<T>& target, size_t position, size_t count, std::vector<T>& items)
+    {
+        const size_t common = std::min(count, items.size());
+        std::move(items.begin(), items.begin() + common, target.begin() + position);
+
+        const auto tail = target.begin() + position + common;
+        if (count > common) {
+            target.erase(tail, tail + (count - common));
+        }
+        else {
+            target.insert(tail,
+                std::make_move_iterator(items.begin() + common),
+                std::make_move_iterator(items.end()));
+        }
+    }
+
+    /// @brief Splits the text at every '\n'. Always returns at least one paragraph.
+    std::vector<std::string_view> splitParagraphs(std::string_view text)
+    {
+        std::vector<std::string_view> paragraphs;
+        size_t start = 0;
+        while (true) {
+            const size_t end = std::min(text.find('\n', start), text.size());
+            paragraphs.push_back(text.substr(start, end - start));
+            if (end == text.size()) break;
+            start = end + 1;
+        }
+        return paragraphs;
+    }
+}
+
+void TextWrapper::wrapParagraph(
+    std::string_view paragraph,
+    FontMetrics& metrics,
+    int maxWidth,
+    std::vector<std::string>& lines,
+    std::vector<int>& widths
+) {
+    size_t lineStart = 0;
+    // The width of [lineStart, i)
+    int lineWidth = 0;
+
+    bool inWord = false;
+    size_t wordStart = 0;
+    // The line width before the word, and the kerning between the word and what precedes it
+    int widthBeforeWord = 0, kerningBeforeWord = 0;
+
+    // Moves the word that just ended to a new line if it overflows
+    const auto endWord = [&]() {
+        inWord = false;
+        if (lineWidth <= maxWidth || wordStart == lineStart) return;
+
+        lines.emplace_back(paragraph.substr(lineStart, wordStart - lineStart));
+        widths.push_back(widthBeforeWord);
+
+        lineStart = wordStart;
+        lineWidth -= widthBeforeWord + kerningBeforeWord;
+    };
+
+    Uint32 previous = 0;
+    for (size_t i = 0; i < paragraph.size();) {
+        const size_t position = i;
+        const Uint32 codepoint = decodeUtf8(paragraph, i);
+        // No kerning against the last glyph of the previous line
+        const int kerning = position == lineStart ? 0 : metrics.kerning(previous, codepoint);
+
+        if (codepoint == ' ') {
+            if (inWord) endWord();
+        }
+        else if (!inWord) {
+            inWord = true;
+            wordStart = position;
+            widthBeforeWord = lineWidth;
+            kerningBeforeWord = kerning;
+        }
+
+        lineWidth += kerning + metrics.advance(codepoint);
+        previous = codepoint;
+    }
+    if (inWord) endWord();
+
+    lines.emplace_back(paragraph.substr(lineStart));
+    widths.push_back(lineWidth);
+}
+
+void TextWrapper::update(std::string_view text, TTF_Font* newFont, int newMaxWidth)
+{
+    if (!matches(newFont, newMaxWidth) || !hasSource) {
+        font = newFont;
+        maxWidth = newMaxWidth;
+        valid = true;
+
+        paragraphs.clear();
+        lines.clear();
+        widths.clear();
+        coveredBytes = 0;
+        splice(0, 0, splitParagraphs(text));
+
+        source.assign(text);
+        hasSource = true;
+        return;
+    }
+
+    const size_t oldSize = source.size(), newSize = text.size();
+    const size_t limit = std::min(oldSize, newSize);
+
+    size_t prefix = 0;
+    while (prefix < limit && source[prefix] == text[prefix]) ++prefix;
+    if (prefix == oldSize && oldSize == newSize) return; // Nothing changed
+
+    size_t suffix = 0;
+    while (suffix < limit - prefix && source[oldSize - 1 - suffix] == text[newSize - 1 - suffix]) ++suffix;
+
+    // The paragraphs touched by the edit, in the old text
+    const size_t first = paragraphAt(prefix);
+    const size_t last = paragraphAt(oldSize - suffix);
+    const size_t start = paragraphs[first].start;
+    const size_t oldEnd = last + 1 < paragraphs.size() ? paragraphs[last + 1].start - 1 : oldSize;
+    const size_t newEnd = oldEnd + newSize - oldSize;
+
+    // Rewrap them from the new text
+    splice(first, last - first + 1, splitParagraphs(text.substr(start, newEnd - start)));
+
+    source.replace(prefix, oldSize - suffix - prefix, text.substr(prefix, newSize - suffix - prefix));
+}
+
+bool TextWrapper::matches(TTF_Font* otherFont, int otherMaxWidth) const
+{
+    return valid && font == otherFont && maxWidth == otherMaxWidth;
+}
+
+void TextWrapper::assignParagraphs(const std::vector<std::string>& newParagraphs, TTF_Font* newFont, int newMaxWidth)
+{
+    font = newFont;
+    maxWidth = newMaxWidth;
+    valid = true;
+
+    paragraphs.clear();
+    lines.clear();
+    widths.clear();
+    coveredBytes = 0;
+    replaceParagraphs(0, 0, newParagraphs);
+}
+
+void TextWrapper::replaceParagraphs(size_t first, size_t count, const std::vector<std::string>& newParagraphs)
+{
+    splice(first, count, std::vector<std::string_view>(newParagraphs.begin(), newParagraphs.end()));
+
+    // The owner keeps the text, update() has to start over
+    source.clear();
+    hasSource = false;
+}
+
+void TextWrapper::splice(size_t first, size_t count, const std::vector<std::string_view>& newParagraphs)
+{
+    auto& metrics = FontMetrics::get(font);
+
+    // The bytes covered by the replaced paragraphs, their '\n' included
+    const size_t start = first < paragraphs.size() ? paragraphs[first].start : coveredBytes;
+    const size_t oldEnd = first + count < paragraphs.size() ? paragraphs[first + count].start : coveredBytes;
+    const size_t firstLine = first < paragraphs.size() ? paragraphs[first].firstLine : lines.size();
+    const size_t oldLineCount = (first + count < paragraphs.size() ? paragraphs[first + count].firstLine : lines.size()) - firstLine;
+
+    std::vector<std::string> newLines;
+    std::vector<int> newWidths;
+    std::vector<Paragraph> wrapped;
+    wrapped.reserve(newParagraphs.size());
+
+    size_t offset = start;
+    for (const auto& paragraph : newParagraphs) {
+        const size_t lineIndex = firstLine + newLines.size();
+        wrapParagraph(paragraph, metrics, maxWidth, newLines, newWidths);
+        wrapped.push_back({ offset, lineIndex, firstLine + newLines.size() - lineIndex });
+        offset += paragraph.size() + 1;
+    }
+
+    const auto lineDelta = static_cast<std::ptrdiff_t>(newLines.size()) - static_cast<std::ptrdiff_t>(oldLineCount);
+    const auto byteDelta = static_cast<std::ptrdiff_t>(offset) - static_cast<std::ptrdiff_t>(oldEnd);
+
+    replaceRange(lines, firstLine, oldLineCount, newLines);
+    replaceRange(widths, firstLine, oldLineCount, newWidths);
+    replaceRange(paragraphs, first, count, wrapped);
+
+    // Shift the paragraphs after the edit
+    for (size_t i = first + newParagraphs.size(); i < paragraphs.size(); ++i) {
+        paragraphs[i].start += byteDelta;
+        paragraphs[i].firstLine += lineDelta;
+    }
+
+    coveredBytes = static_cast<size_t>(static_cast<std::ptrdiff_t>(coveredBytes) + byteDelta);
+}
+
+size_t TextWrapper::paragraphAt(size_t offset) const
+{
+    const auto it = std::upper_bound(paragraphs.begin(), paragraphs.end(), offset,
+        [](size_t value, const Paragraph& paragraph) { return value < paragraph.start; });
+    return static_cast<size_t>(it - paragraphs.begin()) - 1;
+}
+
+const std::vector<std::string>& TextWrapper::getLines() const
+{
+    return lines;
+}
+
+const std::vector<int>& TextWrapper::getWidths() const
+{
+    return widths;
+}
+
+size_t TextWrapper::paragraphCount() const
+{
+    return paragraphs.size();
+}
+
+size_t TextWrapper::paragraphFirstLine(size_t paragraph) const
+{
+    return paragraphs[paragraph].firstLine;
+}
+
+size_t TextWrapper::paragraphLineCount(size_t paragraph) const
+{
+    return paragraphs[paragraph].lineCount;
+}
+
+size_t TextWrapper::paragraphOfLine(size_t line) const
+{
+    const auto it = std::upper_bound(paragraphs.begin(), paragraphs.end(), line,
+        [](size_t value, const Paragraph& paragraph) { return value < paragraph.firstLine; });
+    return static_cast<size_t>(it - paragraphs.begin()) - 1;
+}
+
+void TextWrapper::clear()
+{
+    valid = false;
+    hasSource = false;
+    coveredBytes = 0;
+    source.clear();
+    paragraphs.clear();
+    lines.clear();
+    widths.clear();
+}
@@ -0,0 +1,235 @@
+#include "textureCache.h"
+#include "workerPool.h"
+#include "imageAtlas.h"
+
+using namespace GUILib::Reserved;
+
+namespace {
+    std::unordered_map<SDL_Renderer*, std::unique_ptr<TextureCache>>& textureCaches()
+    {
+        static std::unordered_map<SDL_Renderer*, std::unique_ptr<TextureCache>> caches;
+        return caches;
+    }
+
+    size_t textureBytes(SDL_Texture* texture)
+    {
+        Uint32 format = 0;
+        int w = 0, h = 0;
+        SDL_QueryTexture(texture, &format, nullptr, &w, &h);
+        // Some formats report no size per pixel, count them as 32 bits
+        const int bytesPerPixel = SDL_BYTESPERPIXEL(format) > 0 ? SDL_BYTESPERPIXEL(format) : 4;
+        return static_cast<size_t>(w) * static_cast<size_t>(h) * static_cast<size_t>(bytesPerPixel);
+    }
+
+    /// The event pushed by the workers once a file is decoded, registered on the render thread.
+    Uint32 decodedEventType()
+    {
+        static const Uint32 type = SDL_RegisterEvents(1);
+        return type;
+    }
+}
+
+TextureCache::TextureCache(SDL_Renderer* r) : renderer(r) {}
+
+TextureCache::~TextureCache() = default;
+
+TextureCache::Inbox::~Inbox()
+{
+    for (const auto& d : decoded) {
+        if (d.surface) SDL_FreeSurface(d.surface);
+    }
+}
+
+TextureCache& TextureCache::get(SDL_Renderer* r)
+{
+    auto& cache = textureCaches()[r];
+    if (!cache) cache = std::make_unique<TextureCache>(r);
+    return *cache;
+}
+
+void TextureCache::releaseRenderer(SDL_Renderer* r)
+{
+    textureCaches().erase(r);
+}
+
+TextureRegion TextureCache::load(const std::string& path)
+{
+    if (!renderer || path.empty()) return {};
+
+    if (const auto it = lookup.find(path); it != lookup.end()) {
+        // Move to the front, most recently used
+        entries.splice(entries.begin(), entries, it->second);
+        it->second->claimed = true;
+        stats.hits++;
+        return it->second->region;
+    }
+
+    stats.misses++;
+
+    SDL_Surface* surface = IMG_Load(path.c_str());
+    if (!surface) return {};
+    return insert(path, surface, true);
+}
+
+std::optional<TextureRegion> TextureCache::loadAsync(const std::string& path, std::shared_ptr<Waiter> waiter)
+{
+    if (!renderer || path.empty()) return {};
+
+    uploadDecoded();
+
+    if (const auto it = lookup.find(path); it != lookup.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        it->second->claimed = true;
+        stats.hits++;
+        return it->second->region;
+    }
+    if (const auto it = failed.find(path); it != failed.end()) {
+        SDL_SetError("%s", it->second.c_str());
+        return TextureRegion();
+    }
+
+    if (waiter) waiters[path].push_back(std::move(waiter));
+
+    // Several objects waiting on the same file share one decode
+    if (decoding.insert(path).second) {
+        stats.misses++;
+        WorkerPool::get().submit([target = std::weak_ptr<Inbox>(inbox), path, eventType = decodedEventType()] {
+            // Released in the meantime, nobody wants it anymore
+            if (target.expired()) return;
+
+            SDL_Surface* surface = IMG_Load(path.c_str());
+            Decoded result { path, surface, surface ? std::string() : SDL_GetError() };
+
+            if (const auto box = target.lock()) {
+                {
+                    std::lock_guard lock(box->mutex);
+                    box->decoded.push_back(std::move(result));
+                }
+                // Wakes up the render thread if it's waiting for events
+                if (eventType != static_cast<Uint32>(-1)) {
+                    SDL_Event event {};
+                    event.type = eventType;
+                    SDL_PushEvent(&event);
+                }
+            }
+            else if (surface) {
+                SDL_FreeSurface(surface);
+            }
+        });
+    }
+    return std::nullopt;
+}
+
+void TextureCache::uploadDecoded()
+{
+    std::vector<Decoded> ready;
+    {
+        std::lock_guard lock(inbox->mutex);
+        if (inbox->decoded.empty()) return;
+        ready.swap(inbox->decoded);
+    }
+
+    std::vector<std::shared_ptr<Waiter>> notified;
+    for (auto& d : ready) {
+        decoding.erase(d.path);
+        if (const auto it = waiters.find(d.path); it != waiters.end()) {
+            for (auto& waiter : it->second) notified.push_back(std::move(waiter));
+            waiters.erase(it);
+        }
+
+        if (!d.surface) {
+            failed[d.path] = std::move(d.error);
+        }
+        else if (lookup.count(d.path)) {
+            // Loaded synchronously while it was decoding
+            SDL_FreeSurface(d.surface);
+        }
+        else if (!insert(d.path, d.surface, false)) {
+            failed[d.path] = SDL_GetError();
+        }
+    }
+
+    // Called once every file is in, they may load other ones
+    for (const auto& waiter : notified) {
+        if (*waiter) (*waiter)();
+    }
+}
+
+TextureRegion TextureCache::insert(const std::string& path, SDL_Surface* surface, bool claimed)
+{
+    // Small images go to a shared page, drawn together with their neighbours
+    TextureRegion region = ImageAtlas::get(renderer).pack(surface);
+    size_t regionSize = 0;
+
+    if (!region) {
+        SDL_Texture* created = SDL_CreateTextureFromSurface(renderer, surface);
+        if (created) {
+            region.texture = SharedTexture(created, SDL_DestroyTexture);
+            region.source = { 0, 0, surface->w, surface->h };
+            regionSize = textureBytes(created);
+        }
+    }
+    SDL_FreeSurface(surface);
+    if (!region) return region;
+
+    entries.push_front({ path, region, regionSize, claimed });
+    lookup[path] = entries.begin();
+    bytes += regionSize;
+
+    trim();
+    return region;
+}
+
+void TextureCache::trim()
+{
+    for (auto it = entries.end(); bytes > byteBudget && it != entries.begin();) {
+        --it;
+        // Still shown somewhere, dropping it wouldn't free anything.
+        // Atlas pages are owned by the atlas too, so packed images are never dropped
+        if (it->region.texture.use_count() > 1 || !it->claimed) continue;
+
+        bytes -= it->bytes;
+        lookup.erase(it->path);
+        it = entries.erase(it);
+        stats.evictions++;
+    }
+}
+
+void TextureCache::clear()
+{
+    entries.clear();
+    lookup.clear();
+    failed.clear();
+    bytes = 0;
+}
+
+void TextureCache::setByteBudget(size_t value)
+{
+    byteBudget = value;
+    trim();
+}
+
+size_t TextureCache::getByteBudget() const
+{
+    return byteBudget;
+}
+
+size_t TextureCache::getBytes() const
+{
+    return bytes;
+}
+
+size_t TextureCache::size() const
+{
+    return entries.size();
+}
+
+const TextureCache::Stats& TextureCache::getStats() const
+{
+    return stats;
+}
+
+void TextureCache::resetStats()
+{
+    stats = Stats();
+}
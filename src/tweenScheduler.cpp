@@ -0,0 +1,263 @@
+#include "tweenScheduler.h"
+
+#include <limits>
+
+using namespace GUILib;
+
+std::uint64_t TweenScheduler::key(Reserved::NodeHandle node, TweenType type)
+{
+    return static_cast<std::uint64_t>(node) << 8 | static_cast<std::uint64_t>(type);
+}
+
+TweenHandle TweenScheduler::start(const std::shared_ptr<GuiObject>& obj, TweenType type, const UIUnit& to, double duration,
+    EasingCurve curve)
+{
+    if (type != TweenType::SIZE && type != TweenType::POSITION && type != TweenType::PIVOT) {
+        std::cout << "Only the size, position and pivot offset are tweened to a UIUnit.\n";
+        return {};
+    }
+    const double values[COMPONENTS] = { to.sizeX, to.sizeY, 0.0, 0.0 };
+    return begin(obj, type, values, to.isUsingScale, duration, curve);
+}
+
+TweenHandle TweenScheduler::start(const std::shared_ptr<GuiObject>& obj, TweenType type, double to, double duration,
+    EasingCurve curve)
+{
+    if (type != TweenType::ROTATION && type != TweenType::ALPHA) {
+        std::cout << "Only the rotation and alpha are tweened to a number.\n";
+        return {};
+    }
+    const double values[COMPONENTS] = { to, 0.0, 0.0, 0.0 };
+    return begin(obj, type, values, false, duration, curve);
+}
+
+TweenHandle TweenScheduler::startColor(const std::shared_ptr<GuiObject>& obj, TweenType type, const SDL_Color& to, double duration,
+    EasingCurve curve)
+{
+    if (type != TweenType::COLOR && type != TweenType::TEXT_COLOR) {
+        std::cout << "Only colors are tweened to a color.\n";
+        return {};
+    }
+    double values[COMPONENTS];
+    Reserved::colorToTween(to, values);
+    return begin(obj, type, values, false, duration, curve);
+}
+
+TweenHandle TweenScheduler::startScroll(const std::shared_ptr<GuiObject>& obj, const SDL_Point& to, double duration,
+    EasingCurve curve)
+{
+    const double values[COMPONENTS] = { static_cast<double>(to.x), static_cast<double>(to.y), 0.0, 0.0 };
+    return begin(obj, TweenType::SCROLL, values, false, duration, curve);
+}
+
+bool TweenScheduler::read(const GuiObject& obj, TweenType type, double* from, bool& isScaled)
+{
+    std::fill(from, from + COMPONENTS, 0.0);
+    isScaled = false;
+
+    UIUnit unit;
+    switch (type) {
+    case TweenType::SIZE: unit = obj.getSize(); break;
+    case TweenType::POSITION: unit = obj.getPosition(); break;
+    case TweenType::PIVOT: unit = obj.getPivotOffset(); break;
+    case TweenType::ROTATION:
+        from[0] = obj.getRotation();
+        return true;
+    default:
+        return obj.getTweenValue(type, from);
+    }
+
+    from[0] = unit.sizeX;
+    from[1] = unit.sizeY;
+    isScaled = unit.isUsingScale;
+    return true;
+}
+
+TweenHandle TweenScheduler::begin(const std::shared_ptr<GuiObject>& obj, TweenType type, const double* to, bool isScaled,
+    double duration, EasingCurve curve)
+{
+    if (!obj) return {};
+
+    double from[COMPONENTS];
+    bool fromScaled = false;
+    if (!read(*obj, type, from, fromScaled)) {
+        std::cout << "Tween target not found. The " << obj->getClassName() << " has no such property.\n";
+        return {};
+    }
+    if (fromScaled != isScaled) {
+        std::cout << "Tween position type mismatch. Please use 2 UIUnits with the same isUsingScale property.\n";
+        return {};
+    }
+
+    // A property only has one tween, the new one starts from where the old one got
+    if (const auto found = running.find(key(obj->node, type)); found != running.end())
+        remove(indices[found->second]);
+
+    std::uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<std::uint32_t>(indices.size());
+        indices.push_back(NO_INDEX);
+        generations.push_back(0);
+    }
+    running[key(obj->node, type)] = slot;
+    indices[slot] = static_cast<std::uint32_t>(slots.size());
+
+    progress.push_back(0.0);
+    // A tween without a duration ends at the first step
+    rates.push_back(duration > 0.0 ? 1.0 / duration : std::numeric_limits<double>::max());
+    eased.push_back(0.0);
+    curves.push_back(curve);
+    for (size_t c = 0; c < COMPONENTS; ++c) {
+        starts[c].push_back(from[c]);
+        deltas[c].push_back(to[c] - from[c]);
+        values[c].push_back(from[c]);
+    }
+    nodes.push_back(obj->node);
+    types.push_back(type);
+    scaled.push_back(isScaled);
+    owners.push_back(obj.get());
+    lifetimes.push_back(obj);
+    slots.push_back(slot);
+
+    return { slot, generations[slot] };
+}
+
+bool TweenScheduler::cancel(const TweenHandle& handle)
+{
+    if (!isActive(handle)) return false;
+    remove(indices[handle.slot]);
+    return true;
+}
+
+bool TweenScheduler::isActive(const TweenHandle& handle) const
+{
+    return handle.slot < indices.size() && generations[handle.slot] == handle.generation && indices[handle.slot] != NO_INDEX;
+}
+
+void TweenScheduler::update(double deltaTime)
+{
+    const size_t count = slots.size();
+    if (count == 0) return;
+
+    // One array at a time with no branch, so the compiler can vectorize the loops
+    for (size_t i = 0; i < count; ++i)
+        progress[i] = std::min(progress[i] + deltaTime * rates[i], 1.0);
+
+    // A lookup in the table of the curve, tweens started together mostly share it
+    EasingCurve curve = curves[0];
+    const double* samples = Easing::getSamples(curve);
+    for (size_t i = 0; i < count; ++i) {
+        if (curves[i] != curve) {
+            curve = curves[i];
+            samples = Easing::getSamples(curve);
+        }
+        eased[i] = Easing::interpolate(samples, progress[i]);
+    }
+
+    for (size_t c = 0; c < COMPONENTS; ++c) {
+        const double* start = starts[c].data();
+        const double* delta = deltas[c].data();
+        double* value = values[c].data();
+        for (size_t i = 0; i < count; ++i)
+            value[i] = start[i] + delta[i] * eased[i];
+    }
+
+    auto& store = Reserved::LayoutStore::get();
+    for (size_t i = 0; i < slots.size();) {
+        if (lifetimes[i].expired()) {
+            remove(i);
+            continue;
+        }
+
+        apply(i, store);
+
+        // The last one moves in, it has been advanced already
+        if (progress[i] >= 1.0) remove(i);
+        else ++i;
+    }
+}
+
+void TweenScheduler::apply(size_t index, Reserved::LayoutStore& store)
+{
+    GuiObject* obj = owners[index];
+    const double current[COMPONENTS] = { values[0][index], values[1][index], values[2][index], values[3][index] };
+    const UIUnit unit { current[0], current[1], scaled[index] != 0 };
+
+    switch (types[index]) {
+    // Only marks the layout out of date, so an object with several tweens is still laid out once
+    case TweenType::POSITION:
+        store.setPosition(nodes[index], unit.sizeX, unit.sizeY, unit.isUsingScale);
+        obj->invalidateLayout();
+        obj->notifyParentGeometry();
+        obj->onPositionChange.fire(unit);
+        break;
+    case TweenType::SIZE:
+        store.setSize(nodes[index], unit.sizeX, unit.sizeY, unit.isUsingScale);
+        obj->invalidateLayout();
+        obj->notifyParentGeometry();
+        obj->onSizeChange.fire(unit);
+        break;
+    case TweenType::PIVOT: obj->setPivotOffset(unit); break;
+    case TweenType::ROTATION: obj->setRotation(current[0]); break;
+    default: obj->setTweenValue(types[index], current); break;
+    }
+}
+
+void TweenScheduler::clear()
+{
+    while (!slots.empty()) remove(slots.size() - 1);
+}
+
+size_t TweenScheduler::size() const
+{
+    return slots.size();
+}
+
+void TweenScheduler::remove(size_t index)
+{
+    const std::uint32_t slot = slots[index];
+    running.erase(key(nodes[index], types[index]));
+    indices[slot] = NO_INDEX;
+    generations[slot]++;
+    freeSlots.push_back(slot);
+
+    const size_t last = slots.size() - 1;
+    if (index != last) {
+        progress[index] = progress[last];
+        rates[index] = rates[last];
+        eased[index] = eased[last];
+        curves[index] = curves[last];
+        for (size_t c = 0; c < COMPONENTS; ++c) {
+            starts[c][index] = starts[c][last];
+            deltas[c][index] = deltas[c][last];
+            values[c][index] = values[c][last];
+        }
+        nodes[index] = nodes[last];
+        types[index] = types[last];
+        scaled[index] = scaled[last];
+        owners[index] = owners[last];
+        lifetimes[index] = std::move(lifetimes[last]);
+        slots[index] = slots[last];
+        indices[slots[index]] = static_cast<std::uint32_t>(index);
+    }
+
+    progress.pop_back();
+    rates.pop_back();
+    eased.pop_back();
+    curves.pop_back();
+    for (size_t c = 0; c < COMPONENTS; ++c) {
+        starts[c].pop_back();
+        deltas[c].pop_back();
+        values[c].pop_back();
+    }
+    nodes.pop_back();
+    types.pop_back();
+    scaled.pop_back();
+    owners.pop_back();
+    lifetimes.pop_back();
+    slots.pop_back();
+}
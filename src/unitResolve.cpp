@@ -0,0 +1,99 @@
+#include "unitResolve.h"
+
+#if defined(GUILIB_UNIT_KERNEL_AVX2)
+#include <immintrin.h>
+#elif defined(GUILIB_UNIT_KERNEL_SSE2)
+#include <emmintrin.h>
+#endif
+
+using namespace GUILib::Reserved;
+
+namespace {
+    void resolveScalar(const UnitBatch& b, size_t first, size_t count)
+    {
+        for (size_t i = first; i < count; ++i) {
+            const bool positionScaled = b.positionMask[i] != 0, sizeScaled = b.sizeMask[i] != 0;
+
+            b.x[i] = b.parentX[i] + (positionScaled ? b.parentW[i] * b.positionX[i] : b.positionX[i]) - b.offsetX[i];
+            b.y[i] = b.parentY[i] + (positionScaled ? b.parentH[i] * b.positionY[i] : b.positionY[i]) - b.offsetY[i];
+            b.w[i] = sizeScaled ? b.parentW[i] * b.sizeX[i] : b.sizeX[i];
+            b.h[i] = sizeScaled ? b.parentH[i] * b.sizeY[i] : b.sizeY[i];
+
+            b.rectX[i] = static_cast<int>(b.x[i]);
+            b.rectY[i] = static_cast<int>(b.y[i]);
+            b.rectW[i] = static_cast<int>(b.w[i]);
+            b.rectH[i] = static_cast<int>(b.h[i]);
+        }
+    }
+}
+
+void GUILib::Reserved::resolveUnits(const UnitBatch& b, size_t count)
+{
+    size_t i = 0;
+
+    // A scaled unit is multiplied by the parent size, a pixel one by 1, picked through the mask instead of a branch.
+    // Multiplying by 1 and adding the same terms in the same order keeps the results of the scalar loop
+#if defined(GUILIB_UNIT_KERNEL_AVX2)
+    const __m256d one = _mm256_set1_pd(1.0);
+    for (; i + 4 <= count; i += 4) {
+        const __m256d positionMask = _mm256_castsi256_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.positionMask + i)));
+        const __m256d sizeMask = _mm256_castsi256_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.sizeMask + i)));
+        const __m256d parentW = _mm256_loadu_pd(b.parentW + i), parentH = _mm256_loadu_pd(b.parentH + i);
+
+        const __m256d x = _mm256_sub_pd(_mm256_add_pd(_mm256_loadu_pd(b.parentX + i),
+            _mm256_mul_pd(_mm256_blendv_pd(one, parentW, positionMask), _mm256_loadu_pd(b.positionX + i))), _mm256_loadu_pd(b.offsetX + i));
+        const __m256d y = _mm256_sub_pd(_mm256_add_pd(_mm256_loadu_pd(b.parentY + i),
+            _mm256_mul_pd(_mm256_blendv_pd(one, parentH, positionMask), _mm256_loadu_pd(b.positionY + i))), _mm256_loadu_pd(b.offsetY + i));
+        const __m256d w = _mm256_mul_pd(_mm256_blendv_pd(one, parentW, sizeMask), _mm256_loadu_pd(b.sizeX + i));
+        const __m256d h = _mm256_mul_pd(_mm256_blendv_pd(one, parentH, sizeMask), _mm256_loadu_pd(b.sizeY + i));
+
+        _mm256_storeu_pd(b.x + i, x);
+        _mm256_storeu_pd(b.y + i, y);
+        _mm256_storeu_pd(b.w + i, w);
+        _mm256_storeu_pd(b.h + i, h);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b.rectX + i), _mm256_cvttpd_epi32(x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b.rectY + i), _mm256_cvttpd_epi32(y));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b.rectW + i), _mm256_cvttpd_epi32(w));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b.rectH + i), _mm256_cvttpd_epi32(h));
+    }
+#elif defined(GUILIB_UNIT_KERNEL_SSE2)
+    const __m128d one = _mm_set1_pd(1.0);
+    const auto select = [](__m128d mask, __m128d scaled, __m128d pixels) {
+        return _mm_or_pd(_mm_and_pd(mask, scaled), _mm_andnot_pd(mask, pixels));
+    };
+    for (; i + 2 <= count; i += 2) {
+        const __m128d positionMask = _mm_castsi128_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.positionMask + i)));
+        const __m128d sizeMask = _mm_castsi128_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.sizeMask + i)));
+        const __m128d parentW = _mm_loadu_pd(b.parentW + i), parentH = _mm_loadu_pd(b.parentH + i);
+
+        const __m128d x = _mm_sub_pd(_mm_add_pd(_mm_loadu_pd(b.parentX + i),
+            _mm_mul_pd(select(positionMask, parentW, one), _mm_loadu_pd(b.positionX + i))), _mm_loadu_pd(b.offsetX + i));
+        const __m128d y = _mm_sub_pd(_mm_add_pd(_mm_loadu_pd(b.parentY + i),
+            _mm_mul_pd(select(positionMask, parentH, one), _mm_loadu_pd(b.positionY + i))), _mm_loadu_pd(b.offsetY + i));
+        const __m128d w = _mm_mul_pd(select(sizeMask, parentW, one), _mm_loadu_pd(b.sizeX + i));
+        const __m128d h = _mm_mul_pd(select(sizeMask, parentH, one), _mm_loadu_pd(b.sizeY + i));
+
+        _mm_storeu_pd(b.x + i, x);
+        _mm_storeu_pd(b.y + i, y);
+        _mm_storeu_pd(b.w + i, w);
+        _mm_storeu_pd(b.h + i, h);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(b.rectX + i), _mm_cvttpd_epi32(x));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(b.rectY + i), _mm_cvttpd_epi32(y));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(b.rectW + i), _mm_cvttpd_epi32(w));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(b.rectH + i), _mm_cvttpd_epi32(h));
+    }
+#endif
+
+    resolveScalar(b, i, count);
+}
+
+std::string_view GUILib::Reserved::getUnitKernelName()
+{
+#if defined(GUILIB_UNIT_KERNEL_AVX2)
+    return "AVX2";
+#elif defined(GUILIB_UNIT_KERNEL_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,69 @@
+#include "workerPool.h"
+
+using namespace GUILib::Reserved;
+
+WorkerPool& WorkerPool::get()
+{
+    // Leave a core to the render thread, and don't hog the machine
+    static WorkerPool pool(std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 5) - 1);
+    return pool;
+}
+
+WorkerPool::WorkerPool(size_t threadCount)
+{
+    threadCount = std::max<size_t>(1, threadCount);
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    available.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    available.notify_one();
+}
+
+size_t WorkerPool::pending()
+{
+    std::lock_guard lock(mutex);
+    return jobs.size();
+}
+
+size_t WorkerPool::size() const
+{
+    return workers.size();
+}
+
+void WorkerPool::work()
+{
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(mutex);
+            available.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}